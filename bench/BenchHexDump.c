@@ -0,0 +1,92 @@
+/* Hex dump benchmark
+ *
+ * Compares three ways of logging a binary buffer as hex:
+ *   - per-byte helper: one function call per byte, then "%s"
+ *   - %*b specifier: the whole buffer in one message
+ *   - log_hexdump(): 16 bytes per message, with offsets and ASCII column
+ *
+ * Build once with the default flags (SSE2/NEON kernel) and once with
+ * -DLOG_NO_SIMD (scalar kernel) to compare the two; see bench/Makefile.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_c.h"
+
+#define ITERATIONS 200000
+#define BUFFER_SIZE 112 /* Fits one %*b message in LOG_MAX_MESSAGE_SIZE */
+
+static volatile size_t g_sink_bytes;
+
+/* Discard output, but keep the compiler from removing the work */
+static void null_output(const char* message, size_t length) {
+    (void)message;
+    g_sink_bytes += length;
+}
+
+/* Typical application helper: format one byte per call */
+__attribute__((noinline))
+static size_t hex_byte(unsigned char value, char* out) {
+    const char* hex_chars = "0123456789abcdef";
+    out[0] = hex_chars[value >> 4];
+    out[1] = hex_chars[value & 0x0F];
+    return 2;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void report(const char* name, double elapsed_ns, size_t bytes) {
+    printf("%-18s %8.1f ns/call %8.2f ns/byte\n", name,
+           elapsed_ns / ITERATIONS, elapsed_ns / ((double)ITERATIONS * bytes));
+}
+
+int main(void) {
+    unsigned char data[BUFFER_SIZE];
+    char text[2 * BUFFER_SIZE + 1];
+    double start;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 131 + 7);
+    }
+
+    log_set_output_callback(null_output);
+
+#if defined(LOG_NO_SIMD)
+    printf("hex kernel: scalar, %d bytes\n", BUFFER_SIZE);
+#else
+    printf("hex kernel: SIMD if available, %d bytes\n", BUFFER_SIZE);
+#endif
+
+    start = now_ns();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        size_t pos = 0;
+        for (size_t i = 0; i < sizeof(data); i++) {
+            pos += hex_byte(data[i], text + pos);
+        }
+        text[pos] = '\0';
+        loginfo("%s", text);
+    }
+    report("per-byte helper", now_ns() - start, sizeof(data));
+
+    start = now_ns();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        loginfo("%*b", (int)sizeof(data), data);
+    }
+    report("%*b", now_ns() - start, sizeof(data));
+
+    start = now_ns();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        log_hexdump(info, NULL, data, sizeof(data));
+    }
+    report("log_hexdump", now_ns() - start, sizeof(data));
+
+    return (g_sink_bytes == 0);
+}
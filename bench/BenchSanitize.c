@@ -0,0 +1,114 @@
+/* %s sanitizing benchmark
+ *
+ * Logs a large string argument with:
+ *   - sanitizing off (raw copy, the default)
+ *   - a per-byte escaping helper in the application, then raw "%s"
+ *   - sanitizing on, for clean ASCII, for input with one control byte
+ *     every 64 bytes, and for UTF-8 text (every fourth character
+ *     non-ASCII)
+ *
+ * Messages are large (LOG_MAX_MESSAGE_SIZE is raised in bench/Makefile)
+ * so the copy dominates. Build once with the default flags (SSE2/NEON
+ * scan) and once with -DLOG_NO_SIMD (scalar scan) to compare the two.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_c.h"
+
+#define ITERATIONS 100000
+#define PAYLOAD_SIZE 2048
+
+static volatile size_t g_sink_bytes;
+
+/* Discard output, but keep the compiler from removing the work */
+static void null_output(const char* message, size_t length) {
+    (void)message;
+    g_sink_bytes += length;
+}
+
+/* Typical application helper: escape one byte per iteration */
+__attribute__((noinline))
+static size_t escape_bytes(const char* src, char* dst, size_t dst_size) {
+    const char* hex_chars = "0123456789abcdef";
+    size_t pos = 0;
+
+    for (; *src != '\0' && pos + 4 < dst_size; src++) {
+        unsigned char c = (unsigned char)*src;
+        if (c < 0x20 || c == 0x7F) {
+            dst[pos++] = '\\';
+            dst[pos++] = 'x';
+            dst[pos++] = hex_chars[c >> 4];
+            dst[pos++] = hex_chars[c & 0x0F];
+        } else {
+            dst[pos++] = (char)c;
+        }
+    }
+    dst[pos] = '\0';
+    return pos;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void report(const char* name, double elapsed_ns) {
+    printf("%-22s %8.1f ns/call %8.3f ns/byte\n", name,
+           elapsed_ns / ITERATIONS, elapsed_ns / ((double)ITERATIONS * PAYLOAD_SIZE));
+}
+
+static void run(const char* name, const char* payload) {
+    double start = now_ns();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        loginfo("%s", payload);
+    }
+    report(name, now_ns() - start);
+}
+
+int main(void) {
+    static char clean[PAYLOAD_SIZE + 1];
+    static char dirty[PAYLOAD_SIZE + 1];
+    static char utf8[PAYLOAD_SIZE + 1];
+    static char escaped[4 * PAYLOAD_SIZE + 1];
+
+    for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+        clean[i] = (char)('a' + i % 26);
+        dirty[i] = (i % 64 == 63) ? '\n' : clean[i];
+    }
+    /* "abc" followed by U+00E9 (2 bytes), repeated */
+    for (size_t i = 0; i + 5 <= PAYLOAD_SIZE; i += 5) {
+        memcpy(utf8 + i, "abc\xc3\xa9", 5);
+    }
+    memset(utf8 + PAYLOAD_SIZE - PAYLOAD_SIZE % 5, 'a', PAYLOAD_SIZE % 5);
+
+    log_set_output_callback(null_output);
+
+#if defined(LOG_NO_SIMD)
+    printf("sanitize scan: scalar, %d bytes\n", PAYLOAD_SIZE);
+#else
+    printf("sanitize scan: SIMD if available, %d bytes\n", PAYLOAD_SIZE);
+#endif
+
+    log_set_sanitize(false);
+    run("raw, clean", clean);
+
+    double start = now_ns();
+    for (int iter = 0; iter < ITERATIONS; iter++) {
+        escape_bytes(dirty, escaped, sizeof(escaped));
+        loginfo("%s", escaped);
+    }
+    report("per-byte helper, dirty", now_ns() - start);
+
+    log_set_sanitize(true);
+    run("sanitize, clean", clean);
+    run("sanitize, dirty", dirty);
+    run("sanitize, utf-8", utf8);
+
+    return (g_sink_bytes == 0);
+}
@@ -0,0 +1,56 @@
+/* Span benchmark
+ *
+ * Measures the cost of one logspan() scope with recording enabled and
+ * disabled at runtime. Buffers are reset between batches so every span
+ * is actually recorded.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "log_c.h"
+#include "log_c_trace.h"
+
+#define BATCH 4000 /* Below LOG_TRACE_BUFFER_EVENTS */
+#define BATCHES 250
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+__attribute__((noinline))
+static void traced_function(void) {
+    logspan("traced_function");
+    __asm__ volatile("" ::: "memory");
+}
+
+static double measure(void) {
+    double total = 0.0;
+
+    for (int batch = 0; batch < BATCHES; batch++) {
+        log_trace_reset();
+        double start = now_ns();
+        for (int i = 0; i < BATCH; i++) {
+            traced_function();
+        }
+        total += now_ns() - start;
+    }
+
+    return total / ((double)BATCH * BATCHES);
+}
+
+int main(void) {
+    log_trace_set_enabled(false);
+    printf("%-18s %8.1f ns/span\n", "disabled", measure());
+
+    log_trace_set_enabled(true);
+    printf("%-18s %8.1f ns/span\n", "enabled", measure());
+
+    return (log_trace_dropped() != 0);
+}
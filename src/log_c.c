@@ -14,11 +14,74 @@
 
 #include "log_c.h"
 
+/* SIMD kernels for hex encoding and %s sanitizing (define LOG_NO_SIMD to
+ * force scalar code) */
+#if !defined(LOG_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define LOG_SIMD_SSE2 1
+#elif !defined(LOG_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define LOG_SIMD_NEON 1
+#endif
+
+/* Optional features, each compiled in unless disabled. Define these to
+ * shrink the library on small targets:
+ *   LOG_NO_LAYOUT    log_set_layout() only accepts NULL (default layout)
+ *   LOG_NO_HEXDUMP   log_hexdump() is a no-op and %*b prints nothing
+ *   LOG_NO_SANITIZE  log_set_sanitize() is ignored; %s is copied raw */
+
 /* Configuration: Maximum message buffer size */
 #ifndef LOG_MAX_MESSAGE_SIZE
 #define LOG_MAX_MESSAGE_SIZE 256
 #endif
 
+/* Configuration: Maximum label length shown on each hex dump line */
+#ifndef LOG_HEXDUMP_LABEL_SIZE
+#define LOG_HEXDUMP_LABEL_SIZE 32
+#endif
+
+/* Configuration: Maximum length of a component name (including null) */
+#ifndef LOG_CONTEXT_COMPONENT_SIZE
+#define LOG_CONTEXT_COMPONENT_SIZE 32
+#endif
+
+/* Configuration: Size of the pre-rendered per-thread context prefix.
+ * The default fits every field at its longest:
+ * "[" "tid=" 10 digits " " "req=" 10 digits " " component "] ", plus the
+ * spare byte the copy helpers keep free. */
+#ifndef LOG_CONTEXT_PREFIX_SIZE
+#define LOG_CONTEXT_PREFIX_SIZE \
+    (1 + 4 + 10 + 1 + 4 + 10 + 1 + (LOG_CONTEXT_COMPONENT_SIZE - 1) + 2 + 1)
+#endif
+
+/* Configuration: Maximum number of operations in a compiled layout */
+#ifndef LOG_LAYOUT_MAX_OPS
+#define LOG_LAYOUT_MAX_OPS 32
+#endif
+
+/* Configuration: Maximum total length of literal text in a layout */
+#ifndef LOG_LAYOUT_MAX_LITERALS
+#define LOG_LAYOUT_MAX_LITERALS 128
+#endif
+
+/* Thread-local storage qualifier for the per-thread context.
+ * TLS is only used by default on hosted OS targets: bare-metal toolchains
+ * (e.g. arm-none-eabi) accept _Thread_local but usually lack the runtime
+ * support (__aeabi_read_tp, emutls) to link it. Define LOG_THREAD_LOCAL to
+ * choose the qualifier, or LOG_NO_THREAD_LOCAL to force a plain static. */
+#ifndef LOG_THREAD_LOCAL
+#if defined(LOG_NO_THREAD_LOCAL) || !defined(__STDC_HOSTED__) || !__STDC_HOSTED__ || \
+    !(defined(__unix__) || defined(__APPLE__) || defined(_WIN32))
+#define LOG_THREAD_LOCAL
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define LOG_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define LOG_THREAD_LOCAL __thread
+#else
+#define LOG_THREAD_LOCAL
+#endif
+#endif
+
 /*=============================================================================
  * Internal Formatting Utilities
  *============================================================================*/
@@ -142,6 +205,338 @@ static size_t copy_string(const char* str, char* buffer, size_t buf_size) {
     return i;
 }
 
+/**
+ * @brief Copy a buffer of known length
+ * @param src Source bytes
+ * @param length Number of bytes in src
+ * @param buffer Output buffer
+ * @param buf_size Size of output buffer
+ * @return Number of characters written
+ */
+static size_t copy_bytes(const char* src, size_t length, char* buffer,
+                         size_t buf_size) {
+    if (buf_size == 0) return 0;
+    
+    if (length > buf_size - 1) {
+        length = buf_size - 1;
+    }
+    memcpy(buffer, src, length);
+    
+    return length;
+}
+
+#ifndef LOG_NO_HEXDUMP
+
+/**
+ * @brief Encode bytes as lowercase hexadecimal (two characters per byte)
+ *
+ * Uses SSE2 or NEON to convert 16 bytes per iteration where available and
+ * a table lookup for the remainder. No null terminator is written.
+ *
+ * @param src Source bytes
+ * @param length Number of bytes to encode
+ * @param dst Output buffer of at least 2 * length characters
+ */
+static void hex_encode(const unsigned char* src, size_t length, char* dst) {
+    const char* hex_chars = "0123456789abcdef";
+    
+#if defined(LOG_SIMD_SSE2)
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i ascii_zero = _mm_set1_epi8('0');
+    const __m128i alpha_offset = _mm_set1_epi8('a' - '0' - 10);
+    
+    for (; length >= 16; length -= 16, src += 16, dst += 32) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)src);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+        __m128i lo = _mm_and_si128(bytes, low_mask);
+        
+        /* nibble + '0', plus the gap to 'a' for nibbles above 9 */
+        hi = _mm_add_epi8(_mm_add_epi8(hi, ascii_zero),
+                          _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha_offset));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, ascii_zero),
+                          _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha_offset));
+        
+        /* Interleave: high nibble first for each byte */
+        _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#elif defined(LOG_SIMD_NEON)
+    const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+    const uint8x16_t nine = vdupq_n_u8(9);
+    const uint8x16_t ascii_zero = vdupq_n_u8('0');
+    const uint8x16_t alpha_offset = vdupq_n_u8('a' - '0' - 10);
+    
+    for (; length >= 16; length -= 16, src += 16, dst += 32) {
+        uint8x16_t bytes = vld1q_u8(src);
+        uint8x16x2_t out;
+        
+        out.val[0] = vshrq_n_u8(bytes, 4);
+        out.val[1] = vandq_u8(bytes, low_mask);
+        out.val[0] = vaddq_u8(vaddq_u8(out.val[0], ascii_zero),
+                              vandq_u8(vcgtq_u8(out.val[0], nine), alpha_offset));
+        out.val[1] = vaddq_u8(vaddq_u8(out.val[1], ascii_zero),
+                              vandq_u8(vcgtq_u8(out.val[1], nine), alpha_offset));
+        
+        /* vst2q interleaves high and low nibble characters */
+        vst2q_u8((uint8_t*)dst, out);
+    }
+#endif
+    
+    for (size_t i = 0; i < length; i++) {
+        dst[2 * i] = hex_chars[src[i] >> 4];
+        dst[2 * i + 1] = hex_chars[src[i] & 0x0F];
+    }
+}
+
+/**
+ * @brief Render bytes as printable ASCII, replacing others with '.'
+ * @param src Source bytes
+ * @param length Number of bytes
+ * @param dst Output buffer of at least length characters
+ */
+static void hex_ascii(const unsigned char* src, size_t length, char* dst) {
+#if defined(LOG_SIMD_SSE2)
+    const __m128i space_minus_one = _mm_set1_epi8(0x1F);
+    const __m128i delete_char = _mm_set1_epi8(0x7F);
+    const __m128i dot = _mm_set1_epi8('.');
+    
+    for (; length >= 16; length -= 16, src += 16, dst += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)src);
+        /* Signed compares: bytes >= 0x80 are negative and fail the first */
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(bytes, space_minus_one),
+                                          _mm_cmplt_epi8(bytes, delete_char));
+        _mm_storeu_si128((__m128i*)dst,
+                         _mm_or_si128(_mm_and_si128(printable, bytes),
+                                      _mm_andnot_si128(printable, dot)));
+    }
+#elif defined(LOG_SIMD_NEON)
+    const uint8x16_t space = vdupq_n_u8(0x20);
+    const uint8x16_t tilde = vdupq_n_u8(0x7E);
+    const uint8x16_t dot = vdupq_n_u8('.');
+    
+    for (; length >= 16; length -= 16, src += 16, dst += 16) {
+        uint8x16_t bytes = vld1q_u8(src);
+        uint8x16_t printable = vandq_u8(vcgeq_u8(bytes, space), vcleq_u8(bytes, tilde));
+        vst1q_u8((uint8_t*)dst, vbslq_u8(printable, bytes, dot));
+    }
+#endif
+    
+    for (size_t i = 0; i < length; i++) {
+        dst[i] = (src[i] >= 0x20 && src[i] <= 0x7E) ? (char)src[i] : '.';
+    }
+}
+
+/**
+ * @brief Format a byte buffer as compact lowercase hexadecimal
+ *
+ * Only whole bytes are written; the output is truncated to what fits.
+ *
+ * @param data Source bytes
+ * @param length Number of bytes
+ * @param buffer Output buffer
+ * @param buf_size Size of output buffer
+ * @return Number of characters written
+ */
+static size_t format_hex_buffer(const unsigned char* data, size_t length,
+                                char* buffer, size_t buf_size) {
+    if (buf_size == 0 || data == NULL) return 0;
+    
+    size_t max_bytes = (buf_size - 1) / 2;
+    if (length > max_bytes) {
+        length = max_bytes;
+    }
+    
+    hex_encode(data, length, buffer);
+    return 2 * length;
+}
+
+#endif /* LOG_NO_HEXDUMP */
+
+#ifndef LOG_NO_SANITIZE
+
+/**
+ * @brief Count the leading bytes that are printable ASCII (0x20..0x7E)
+ *
+ * Uses SSE2 or NEON to test 16 bytes per iteration where available; the
+ * scalar loop finishes the tail and locates the exact byte when a vector
+ * contains one that is not printable.
+ *
+ * @param src Source bytes
+ * @param length Number of bytes
+ * @return Length of the printable prefix
+ */
+static size_t printable_prefix(const unsigned char* src, size_t length) {
+    size_t i = 0;
+
+#if defined(LOG_SIMD_SSE2)
+    const __m128i space_minus_one = _mm_set1_epi8(0x1F);
+    const __m128i delete_char = _mm_set1_epi8(0x7F);
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+        /* Same signed-compare trick as hex_ascii() */
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(bytes, space_minus_one),
+                                          _mm_cmplt_epi8(bytes, delete_char));
+        unsigned int special = (unsigned int)_mm_movemask_epi8(printable) ^ 0xFFFFu;
+        if (special != 0) {
+#if defined(__GNUC__)
+            return i + (size_t)__builtin_ctz(special);
+#else
+            break;
+#endif
+        }
+    }
+#elif defined(LOG_SIMD_NEON)
+    const uint8x16_t space = vdupq_n_u8(0x20);
+    const uint8x16_t tilde = vdupq_n_u8(0x7E);
+
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t bytes = vld1q_u8(src + i);
+        uint8x16_t printable = vandq_u8(vcgeq_u8(bytes, space), vcleq_u8(bytes, tilde));
+        uint64x2_t special = vreinterpretq_u64_u8(vmvnq_u8(printable));
+        if ((vgetq_lane_u64(special, 0) | vgetq_lane_u64(special, 1)) != 0) {
+            break;
+        }
+    }
+#endif
+
+    while (i < length && src[i] >= 0x20 && src[i] <= 0x7E) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Length of a well-formed UTF-8 sequence starting with a non-ASCII byte
+ *
+ * Rejects overlong forms, surrogates (U+D800..U+DFFF), code points above
+ * U+10FFFF and sequences cut off by the end of the input.
+ *
+ * @param src Sequence start (src[0] >= 0x80)
+ * @param length Bytes available at src
+ * @return Sequence length (2..4), or 0 if not well-formed
+ */
+static size_t utf8_sequence_length(const unsigned char* src, size_t length) {
+    unsigned char lead = src[0];
+    unsigned char second_min = 0x80;
+    unsigned char second_max = 0xBF;
+    size_t size;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        if (lead == 0xE0) second_min = 0xA0;     /* Overlong */
+        if (lead == 0xED) second_max = 0x9F;     /* Surrogates */
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        if (lead == 0xF0) second_min = 0x90;     /* Overlong */
+        if (lead == 0xF4) second_max = 0x8F;     /* Above U+10FFFF */
+    } else {
+        return 0;
+    }
+
+    if (size > length || src[1] < second_min || src[1] > second_max) {
+        return 0;
+    }
+    for (size_t i = 2; i < size; i++) {
+        if ((src[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Write the escape for a byte that may not appear in a log line
+ *
+ * Newline, carriage return and tab become "\n", "\r" and "\t"; any other
+ * byte becomes "\xHH". Nothing is written if the escape does not fit.
+ *
+ * @param c Byte to escape
+ * @param buffer Output buffer
+ * @param avail Characters available in buffer
+ * @return Number of characters written
+ */
+static size_t format_escape(unsigned char c, char* buffer, size_t avail) {
+    const char* hex_chars = "0123456789abcdef";
+    char short_form = (c == '\n') ? 'n' : (c == '\r') ? 'r' : (c == '\t') ? 't' : 0;
+
+    if (short_form != 0) {
+        if (avail < 2) return 0;
+        buffer[0] = '\\';
+        buffer[1] = short_form;
+        return 2;
+    }
+
+    if (avail < 4) return 0;
+    buffer[0] = '\\';
+    buffer[1] = 'x';
+    buffer[2] = hex_chars[c >> 4];
+    buffer[3] = hex_chars[c & 0x0F];
+    return 4;
+}
+
+/**
+ * @brief Copy string to buffer, escaping control bytes and invalid UTF-8
+ *
+ * Runs of printable ASCII are found with printable_prefix() and copied
+ * with memcpy(); only the byte that ends a run goes through the scalar
+ * UTF-8 check or is escaped. Clean ASCII therefore costs one vector scan
+ * plus memcpy(), while text dense in multi-byte characters is handled
+ * about one character at a time. Output is truncated before an escape or
+ * multi-byte sequence that does not fit.
+ *
+ * @param str Source string
+ * @param buffer Output buffer
+ * @param buf_size Size of output buffer
+ * @return Number of characters written
+ */
+static size_t copy_string_sanitized(const char* str, char* buffer, size_t buf_size) {
+    if (buf_size == 0 || str == NULL) return 0;
+
+    /* Every input byte produces at least one output byte, so no more than
+     * buf_size - 1 input bytes can be used; memchr() stops at the null. */
+    const unsigned char* src = (const unsigned char*)str;
+    size_t limit = buf_size - 1;
+    const unsigned char* terminator = memchr(src, '\0', limit);
+    size_t length = (terminator != NULL) ? (size_t)(terminator - src) : limit;
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        size_t run = printable_prefix(src + i, length - i);
+        if (run > limit - pos) {
+            run = limit - pos;
+        }
+        memcpy(buffer + pos, src + i, run);
+        pos += run;
+        i += run;
+
+        if (i >= length || pos >= limit) {
+            break;
+        }
+
+        size_t size = (src[i] >= 0x80) ? utf8_sequence_length(src + i, length - i) : 0;
+        if (size > 0) {
+            if (size > limit - pos) break;
+            memcpy(buffer + pos, src + i, size);
+            pos += size;
+            i += size;
+        } else {
+            size_t written = format_escape(src[i], buffer + pos, limit - pos);
+            if (written == 0) break;
+            pos += written;
+            i++;
+        }
+    }
+
+    return pos;
+}
+
+#endif /* LOG_NO_SANITIZE */
+
 /**
  * @brief Format string with arguments (minimal sprintf-like functionality)
  * 
@@ -152,20 +547,25 @@ static size_t copy_string(const char* str, char* buffer, size_t buf_size) {
  *   %X     - uppercase hexadecimal
  *   %s     - string
  *   %c     - character
+ *   %*b    - byte buffer as hex (int length, then pointer)
  *   %%     - literal %
  *
  * @param buffer Output buffer
  * @param buf_size Size of output buffer
  * @param fmt Format string
  * @param args Variable arguments
+ * @param sanitize Escape control bytes and invalid UTF-8 in %s arguments
  * @return Number of characters written
  */
 static size_t format_string(char* buffer, size_t buf_size, const char* fmt,
-                           va_list args) {
+                           va_list args, bool sanitize) {
     if (buffer == NULL || buf_size == 0 || fmt == NULL) {
         return 0;
     }
     
+#ifdef LOG_NO_SANITIZE
+    (void)sanitize;
+#endif
     size_t pos = 0;
     const char* p = fmt;
     
@@ -206,6 +606,12 @@ static size_t format_string(char* buffer, size_t buf_size, const char* fmt,
                     if (str == NULL) {
                         str = "(null)";
                     }
+#ifndef LOG_NO_SANITIZE
+                    if (sanitize) {
+                        pos += copy_string_sanitized(str, buffer + pos, buf_size - pos);
+                        break;
+                    }
+#endif
                     pos += copy_string(str, buffer + pos, buf_size - pos);
                     break;
                 }
@@ -225,6 +631,31 @@ static size_t format_string(char* buffer, size_t buf_size, const char* fmt,
                     break;
                 }
                 
+                case '*': {
+                    if (p[1] != 'b') {
+                        /* Only %*b takes a '*' argument */
+                        if (pos < buf_size - 2) {
+                            buffer[pos++] = '%';
+                            buffer[pos++] = '*';
+                        }
+                        break;
+                    }
+                    p++; /* Skip '*' */
+                    int len = va_arg(args, int);
+                    const unsigned char* data = va_arg(args, const unsigned char*);
+#ifndef LOG_NO_HEXDUMP
+                    if (len > 0) {
+                        pos += format_hex_buffer(data, (size_t)len, buffer + pos,
+                                                 buf_size - pos);
+                    }
+#else
+                    /* Arguments are still consumed */
+                    (void)len;
+                    (void)data;
+#endif
+                    break;
+                }
+                
                 default:
                     /* Unknown format specifier - just copy it */
                     if (pos < buf_size - 2) {
@@ -254,8 +685,10 @@ static size_t format_string(char* buffer, size_t buf_size, const char* fmt,
  */
 typedef struct {
     log_output_callback_t output_callback;    /**< Output callback function */
+    log_record_callback_t record_callback;    /**< Record callback function */
     volatile log_level_e runtime_level;        /**< Current runtime log level (volatile for thread visibility) */
     log_level_e compile_time_max;              /**< Maximum level compiled into binary */
+    volatile bool sanitize;                    /**< Escape %s arguments */
 } log_context_t;
 
 /**
@@ -268,16 +701,27 @@ typedef struct {
  */
 static log_context_t g_log_ctx = {
     .output_callback = NULL,
+    .record_callback = NULL,
     .runtime_level = LOG_LEVEL,
-    .compile_time_max = LOG_LEVEL
+    .compile_time_max = LOG_LEVEL,
+    .sanitize = false
 };
 
+static void log_site_sync_all(void);
+
 void log_set_output_callback(log_output_callback_t callback) {
     g_log_ctx.output_callback = callback;
+    log_site_sync_all();
+}
+
+void log_set_record_callback(log_record_callback_t callback) {
+    g_log_ctx.record_callback = callback;
+    log_site_sync_all();
 }
 
 bool log_is_output_configured(void) {
-    return (g_log_ctx.output_callback != NULL);
+    return (g_log_ctx.output_callback != NULL ||
+            g_log_ctx.record_callback != NULL);
 }
 
 void log_set_level(log_level_e level) {
@@ -292,6 +736,7 @@ void log_set_level(log_level_e level) {
     }
     
     g_log_ctx.runtime_level = level;
+    log_site_sync_all();
 }
 
 log_level_e log_get_level(void) {
@@ -302,6 +747,276 @@ log_level_e log_get_compile_time_level(void) {
     return g_log_ctx.compile_time_max;
 }
 
+void log_set_sanitize(bool enabled) {
+#ifndef LOG_NO_SANITIZE
+    g_log_ctx.sanitize = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool log_get_sanitize(void) {
+    return g_log_ctx.sanitize;
+}
+
+/*=============================================================================
+ * Per-Thread Context
+ *============================================================================*/
+
+#define LOG_CONTEXT_HAS_THREAD_ID  (1u << 0)
+#define LOG_CONTEXT_HAS_REQUEST_ID (1u << 1)
+#define LOG_CONTEXT_HAS_COMPONENT  (1u << 2)
+
+/**
+ * @brief Per-thread context fields and their rendered prefix
+ *
+ * The prefix and the individual fields used by layouts are re-rendered on
+ * every setter call so that log_vmessage() only has to copy them.
+ */
+typedef struct {
+    unsigned int thread_id_value;                 /**< Thread id as set */
+    char thread_id[12];                           /**< Rendered thread id */
+    size_t thread_id_length;                      /**< Length of thread_id */
+    char request_id[12];                          /**< Rendered request id */
+    size_t request_id_length;                     /**< Length of request_id */
+    char component[LOG_CONTEXT_COMPONENT_SIZE];   /**< Component name (null-terminated) */
+    size_t component_length;                      /**< Length of component */
+    unsigned int fields;                          /**< LOG_CONTEXT_HAS_* bitmask */
+    size_t prefix_length;                         /**< Length of rendered prefix */
+    char prefix[LOG_CONTEXT_PREFIX_SIZE];         /**< Rendered "[tid=.. req=.. comp] " */
+} log_thread_context_t;
+
+static LOG_THREAD_LOCAL log_thread_context_t t_log_thread_ctx;
+
+/**
+ * @brief Render the context fields into the cached prefix
+ */
+static void log_context_render(log_thread_context_t* ctx) {
+    char* buffer = ctx->prefix;
+    const size_t buf_size = sizeof(ctx->prefix);
+    size_t pos = 0;
+    
+    if (ctx->fields == 0) {
+        ctx->prefix_length = 0;
+        return;
+    }
+    
+    buffer[pos++] = '[';
+    
+    if (ctx->fields & LOG_CONTEXT_HAS_THREAD_ID) {
+        pos += copy_string("tid=", buffer + pos, buf_size - pos);
+        pos += copy_bytes(ctx->thread_id, ctx->thread_id_length,
+                          buffer + pos, buf_size - pos);
+    }
+    
+    if (ctx->fields & LOG_CONTEXT_HAS_REQUEST_ID) {
+        if (pos > 1) {
+            pos += copy_string(" ", buffer + pos, buf_size - pos);
+        }
+        pos += copy_string("req=", buffer + pos, buf_size - pos);
+        pos += copy_bytes(ctx->request_id, ctx->request_id_length,
+                          buffer + pos, buf_size - pos);
+    }
+    
+    if (ctx->fields & LOG_CONTEXT_HAS_COMPONENT) {
+        if (pos > 1) {
+            pos += copy_string(" ", buffer + pos, buf_size - pos);
+        }
+        pos += copy_bytes(ctx->component, ctx->component_length,
+                          buffer + pos, buf_size - pos);
+    }
+    
+    pos += copy_string("] ", buffer + pos, buf_size - pos);
+    ctx->prefix_length = pos;
+}
+
+void log_context_set_thread_id(unsigned int thread_id) {
+    t_log_thread_ctx.thread_id_value = thread_id;
+    t_log_thread_ctx.thread_id_length =
+        format_uint(thread_id, t_log_thread_ctx.thread_id,
+                    sizeof(t_log_thread_ctx.thread_id));
+    t_log_thread_ctx.fields |= LOG_CONTEXT_HAS_THREAD_ID;
+    log_context_render(&t_log_thread_ctx);
+}
+
+bool log_context_get_thread_id(unsigned int* thread_id) {
+    if (!(t_log_thread_ctx.fields & LOG_CONTEXT_HAS_THREAD_ID)) {
+        return false;
+    }
+    
+    if (thread_id != NULL) {
+        *thread_id = t_log_thread_ctx.thread_id_value;
+    }
+    return true;
+}
+
+void log_context_set_request_id(unsigned int request_id) {
+    t_log_thread_ctx.request_id_length =
+        format_uint(request_id, t_log_thread_ctx.request_id,
+                    sizeof(t_log_thread_ctx.request_id));
+    t_log_thread_ctx.fields |= LOG_CONTEXT_HAS_REQUEST_ID;
+    log_context_render(&t_log_thread_ctx);
+}
+
+void log_context_clear_request_id(void) {
+    t_log_thread_ctx.fields &= ~LOG_CONTEXT_HAS_REQUEST_ID;
+    log_context_render(&t_log_thread_ctx);
+}
+
+void log_context_set_component(const char* component) {
+    if (component == NULL) {
+        t_log_thread_ctx.fields &= ~LOG_CONTEXT_HAS_COMPONENT;
+    } else {
+        size_t len = copy_string(component, t_log_thread_ctx.component,
+                                 sizeof(t_log_thread_ctx.component));
+        t_log_thread_ctx.component[len] = '\0';
+        t_log_thread_ctx.component_length = len;
+        t_log_thread_ctx.fields |= LOG_CONTEXT_HAS_COMPONENT;
+    }
+    log_context_render(&t_log_thread_ctx);
+}
+
+void log_context_clear(void) {
+    t_log_thread_ctx.fields = 0;
+    log_context_render(&t_log_thread_ctx);
+}
+
+/*=============================================================================
+ * Call-Site Registry
+ *============================================================================*/
+
+#if LOG_SITE_REGISTRY
+/* Bounds of the "log_c_sites" section, provided by the linker. Declared weak
+ * so that binaries without any logging call site still link. */
+extern log_site_t __start_log_c_sites[] __attribute__((weak));
+extern log_site_t __stop_log_c_sites[] __attribute__((weak));
+
+#define LOG_SITES_BEGIN (__start_log_c_sites)
+#define LOG_SITES_END   (__stop_log_c_sites)
+#else
+#define LOG_SITES_BEGIN ((log_site_t*)NULL)
+#define LOG_SITES_END   ((log_site_t*)NULL)
+#endif
+
+/**
+ * @brief Recompute the effective enabled flag of a site
+ */
+static void log_site_sync(log_site_t* site) {
+    bool enabled;
+    
+    if (!log_is_output_configured()) {
+        enabled = false;
+    } else if (site->mode == LOG_SITE_ON) {
+        enabled = true;
+    } else if (site->mode == LOG_SITE_OFF) {
+        enabled = false;
+    } else {
+        enabled = (site->level <= g_log_ctx.runtime_level);
+    }
+    
+    site->enabled = enabled ? 1 : 0;
+}
+
+/**
+ * @brief Recompute the enabled flag of every site
+ *
+ * Called whenever the callback or runtime level changes, so that call sites
+ * never need to look at the global context themselves.
+ */
+static void log_site_sync_all(void) {
+    for (log_site_t* site = LOG_SITES_BEGIN; site < LOG_SITES_END; site++) {
+        log_site_sync(site);
+    }
+}
+
+/**
+ * @brief Match a string against a glob pattern ('*' and '?' wildcards)
+ * @return true if the whole string matches the pattern
+ */
+static bool glob_match(const char* pattern, const char* str) {
+    const char* star = NULL;
+    const char* retry = NULL;
+    
+    while (*str != '\0') {
+        if (*pattern == '*') {
+            /* Remember the star and try matching zero characters first */
+            star = pattern++;
+            retry = str;
+        } else if (*pattern == '?' || *pattern == *str) {
+            pattern++;
+            str++;
+        } else if (star != NULL) {
+            /* Let the last star absorb one more character */
+            pattern = star + 1;
+            str = ++retry;
+        } else {
+            return false;
+        }
+    }
+    
+    while (*pattern == '*') {
+        pattern++;
+    }
+    
+    return (*pattern == '\0');
+}
+
+/**
+ * @brief Match a source path by full path or by basename
+ */
+static bool file_match(const char* pattern, const char* path) {
+    if (glob_match(pattern, path)) {
+        return true;
+    }
+    
+    const char* base = strrchr(path, '/');
+    return (base != NULL && glob_match(pattern, base + 1));
+}
+
+unsigned int log_site_id(const log_site_t* site) {
+    if (site == NULL || site < LOG_SITES_BEGIN || site >= LOG_SITES_END) {
+        return LOG_SITE_ID_NONE;
+    }
+    
+    return (unsigned int)(site - LOG_SITES_BEGIN);
+}
+
+size_t log_site_count(void) {
+    return (size_t)(LOG_SITES_END - LOG_SITES_BEGIN);
+}
+
+const log_site_t* log_site_get(size_t index) {
+    if (index >= log_site_count()) {
+        return NULL;
+    }
+    
+    return &LOG_SITES_BEGIN[index];
+}
+
+size_t log_site_set(const char* file_glob, const char* function_glob,
+                    const char* format_glob, log_site_mode_e mode) {
+    size_t matched = 0;
+    
+    for (log_site_t* site = LOG_SITES_BEGIN; site < LOG_SITES_END; site++) {
+        if (file_glob != NULL && !file_match(file_glob, site->file)) {
+            continue;
+        }
+        if (function_glob != NULL && !glob_match(function_glob, site->function)) {
+            continue;
+        }
+        if (format_glob != NULL &&
+            (site->format == NULL || !glob_match(format_glob, site->format))) {
+            continue;
+        }
+        
+        site->mode = (unsigned char)mode;
+        log_site_sync(site);
+        matched++;
+    }
+    
+    return matched;
+}
+
 /*=============================================================================
  * Logging Implementation
  *============================================================================*/
@@ -341,14 +1056,315 @@ static size_t format_level_prefix(char* buffer, size_t buf_size, log_level_e lev
     return pos;
 }
 
-void log_message(log_level_e level, const char* fmt, ...) {
-    /* Check if output is configured */
-    if (g_log_ctx.output_callback == NULL) {
-        return;
+/**
+ * @brief Copy the pre-rendered per-thread context prefix into buffer
+ * @return Number of characters written
+ */
+static size_t format_context_prefix(char* buffer, size_t buf_size) {
+    const log_thread_context_t* ctx = &t_log_thread_ctx;
+    
+    if (ctx->prefix_length == 0 || ctx->prefix_length >= buf_size) {
+        return 0;
     }
     
-    /* Runtime filtering: Skip if level exceeds runtime threshold */
-    if (level > g_log_ctx.runtime_level) {
+    memcpy(buffer, ctx->prefix, ctx->prefix_length);
+    return ctx->prefix_length;
+}
+
+/*=============================================================================
+ * Pattern Layout
+ *============================================================================*/
+
+#ifndef LOG_NO_LAYOUT
+
+/** @brief Operation kinds of a compiled layout */
+typedef enum {
+    LAYOUT_OP_LITERAL,      /**< Copy literal text */
+    LAYOUT_OP_LEVEL,        /**< %L */
+    LAYOUT_OP_TIMESTAMP,    /**< %T */
+    LAYOUT_OP_THREAD_ID,    /**< %t */
+    LAYOUT_OP_REQUEST_ID,   /**< %r */
+    LAYOUT_OP_COMPONENT,    /**< %m */
+    LAYOUT_OP_CONTEXT,      /**< %C */
+    LAYOUT_OP_MESSAGE,      /**< %M */
+    LAYOUT_OP_FILE,         /**< %F */
+    LAYOUT_OP_LINE,         /**< %l */
+    LAYOUT_OP_FUNCTION      /**< %f */
+} layout_op_e;
+
+/** @brief One compiled layout operation */
+typedef struct {
+    unsigned char type;       /**< layout_op_e */
+    unsigned char length;     /**< Literal length (LAYOUT_OP_LITERAL) */
+    unsigned short offset;    /**< Literal offset in the literal pool */
+} layout_op_t;
+
+/** @brief Longest level name ("critical", "unknown") plus margin */
+#define LAYOUT_LEVEL_NAME_SIZE 12
+
+/**
+ * @brief Compiled layout
+ *
+ * Level names are copied in with their lengths when the layout is set, so
+ * that inserting a level is a fixed-size copy.
+ */
+typedef struct {
+    bool active;                                  /**< false: default layout */
+    size_t op_count;                              /**< Number of operations */
+    layout_op_t ops[LOG_LAYOUT_MAX_OPS];          /**< Operations */
+    char literals[LOG_LAYOUT_MAX_LITERALS];       /**< Literal pool */
+    char level_names[LOG_LEVEL_MAX + 1][LAYOUT_LEVEL_NAME_SIZE]; /**< Level strings */
+    unsigned char level_lengths[LOG_LEVEL_MAX + 1]; /**< Level string lengths */
+    log_timestamp_callback_t timestamp_callback;  /**< Source for %T */
+} log_layout_t;
+
+static log_layout_t g_log_layout = {
+    .active = false,
+    .op_count = 0,
+    .timestamp_callback = NULL
+};
+
+/**
+ * @brief Append a literal character to the layout being compiled
+ *
+ * Consecutive literal characters are merged into one operation.
+ *
+ * @return false if the layout limits are exceeded
+ */
+static bool layout_add_literal(log_layout_t* layout, size_t* literal_size, char c) {
+    if (*literal_size >= sizeof(layout->literals)) {
+        return false;
+    }
+    
+    layout_op_t* last = (layout->op_count > 0) ? &layout->ops[layout->op_count - 1] : NULL;
+    if (last == NULL || last->type != LAYOUT_OP_LITERAL || last->length == 255) {
+        if (layout->op_count >= LOG_LAYOUT_MAX_OPS) {
+            return false;
+        }
+        last = &layout->ops[layout->op_count++];
+        last->type = LAYOUT_OP_LITERAL;
+        last->length = 0;
+        last->offset = (unsigned short)*literal_size;
+    }
+    
+    layout->literals[(*literal_size)++] = c;
+    last->length++;
+    return true;
+}
+
+/**
+ * @brief Compile a layout pattern into operations
+ * @return false on syntax error or if the layout limits are exceeded
+ */
+static bool layout_compile(log_layout_t* layout, const char* pattern) {
+    size_t literal_size = 0;
+    bool has_message = false;
+    
+    layout->op_count = 0;
+    
+    for (const char* p = pattern; *p != '\0'; p++) {
+        if (*p != '%') {
+            if (!layout_add_literal(layout, &literal_size, *p)) return false;
+            continue;
+        }
+        
+        p++;
+        layout_op_e type;
+        switch (*p) {
+            case '%':
+                if (!layout_add_literal(layout, &literal_size, '%')) return false;
+                continue;
+            case 'L': type = LAYOUT_OP_LEVEL; break;
+            case 'T': type = LAYOUT_OP_TIMESTAMP; break;
+            case 't': type = LAYOUT_OP_THREAD_ID; break;
+            case 'r': type = LAYOUT_OP_REQUEST_ID; break;
+            case 'm': type = LAYOUT_OP_COMPONENT; break;
+            case 'C': type = LAYOUT_OP_CONTEXT; break;
+            case 'M':
+                if (has_message) return false;
+                has_message = true;
+                type = LAYOUT_OP_MESSAGE;
+                break;
+            case 'F': type = LAYOUT_OP_FILE; break;
+            case 'l': type = LAYOUT_OP_LINE; break;
+            case 'f': type = LAYOUT_OP_FUNCTION; break;
+            default:
+                return false; /* Unknown specifier or trailing '%' */
+        }
+        
+        if (layout->op_count >= LOG_LAYOUT_MAX_OPS) {
+            return false;
+        }
+        layout->ops[layout->op_count].type = (unsigned char)type;
+        layout->ops[layout->op_count].length = 0;
+        layout->ops[layout->op_count].offset = 0;
+        layout->op_count++;
+    }
+    
+    /* Pre-size the level strings */
+    for (int level = 0; level <= LOG_LEVEL_MAX; level++) {
+        size_t len = copy_string(LOG_LEVEL_TO_C_STRING((log_level_e)level),
+                                 layout->level_names[level],
+                                 sizeof(layout->level_names[level]));
+        layout->level_lengths[level] = (unsigned char)len;
+    }
+    
+    return true;
+}
+
+bool log_set_layout(const char* pattern) {
+    if (pattern == NULL) {
+        g_log_layout.active = false;
+        return true;
+    }
+    
+    /* Compile into a scratch copy so a bad pattern keeps the old layout */
+    log_layout_t compiled = g_log_layout;
+    if (!layout_compile(&compiled, pattern)) {
+        return false;
+    }
+    
+    compiled.active = true;
+    g_log_layout = compiled;
+    return true;
+}
+
+void log_set_timestamp_callback(log_timestamp_callback_t callback) {
+    g_log_layout.timestamp_callback = callback;
+}
+
+/**
+ * @brief Copy a context field, or "-" if it is not set
+ */
+static size_t format_layout_field(const char* value, size_t length, bool set,
+                                  char* buffer, size_t buf_size) {
+    if (!set) {
+        return copy_bytes("-", 1, buffer, buf_size);
+    }
+    return copy_bytes(value, length, buffer, buf_size);
+}
+
+/**
+ * @brief Render a message using the compiled layout
+ * @param text_start Set to the offset of the %M output
+ * @param text_end Set to the end offset of the %M output
+ * @return Number of characters written
+ */
+static size_t format_layout(char* buffer, size_t buf_size, log_level_e level,
+                            const log_site_t* site, const char* fmt,
+                            va_list args, size_t* text_start, size_t* text_end) {
+    const log_layout_t* layout = &g_log_layout;
+    const log_thread_context_t* ctx = &t_log_thread_ctx;
+    size_t pos = 0;
+    
+    *text_start = 0;
+    *text_end = 0;
+    
+    for (size_t i = 0; i < layout->op_count && pos < buf_size - 1; i++) {
+        const layout_op_t* op = &layout->ops[i];
+        char* out = buffer + pos;
+        size_t out_size = buf_size - pos;
+        
+        switch (op->type) {
+            case LAYOUT_OP_LITERAL:
+                pos += copy_bytes(layout->literals + op->offset, op->length,
+                                  out, out_size);
+                break;
+                
+            case LAYOUT_OP_LEVEL:
+                if ((unsigned int)level <= LOG_LEVEL_MAX) {
+                    pos += copy_bytes(layout->level_names[level],
+                                      layout->level_lengths[level], out, out_size);
+                } else {
+                    pos += copy_string(LOG_LEVEL_TO_C_STRING(level), out, out_size);
+                }
+                break;
+                
+            case LAYOUT_OP_TIMESTAMP:
+                if (layout->timestamp_callback != NULL) {
+                    size_t len = layout->timestamp_callback(out, out_size - 1);
+                    pos += (len < out_size) ? len : out_size - 1;
+                }
+                break;
+                
+            case LAYOUT_OP_THREAD_ID:
+                pos += format_layout_field(ctx->thread_id, ctx->thread_id_length,
+                                           ctx->fields & LOG_CONTEXT_HAS_THREAD_ID,
+                                           out, out_size);
+                break;
+                
+            case LAYOUT_OP_REQUEST_ID:
+                pos += format_layout_field(ctx->request_id, ctx->request_id_length,
+                                           ctx->fields & LOG_CONTEXT_HAS_REQUEST_ID,
+                                           out, out_size);
+                break;
+                
+            case LAYOUT_OP_COMPONENT:
+                pos += format_layout_field(ctx->component, ctx->component_length,
+                                           ctx->fields & LOG_CONTEXT_HAS_COMPONENT,
+                                           out, out_size);
+                break;
+                
+            case LAYOUT_OP_CONTEXT:
+                pos += format_context_prefix(out, out_size);
+                break;
+                
+            case LAYOUT_OP_MESSAGE:
+                *text_start = pos;
+                pos += format_string(out, out_size, fmt, args, g_log_ctx.sanitize);
+                *text_end = pos;
+                break;
+                
+            case LAYOUT_OP_FILE:
+                pos += copy_string(site != NULL ? site->file : "-", out, out_size);
+                break;
+                
+            case LAYOUT_OP_LINE:
+                if (site != NULL) {
+                    pos += format_uint(site->line, out, out_size);
+                } else {
+                    pos += copy_bytes("-", 1, out, out_size);
+                }
+                break;
+                
+            case LAYOUT_OP_FUNCTION:
+                pos += copy_string(site != NULL ? site->function : "-", out, out_size);
+                break;
+                
+            default:
+                break;
+        }
+    }
+    
+    return pos;
+}
+
+#else /* LOG_NO_LAYOUT */
+
+bool log_set_layout(const char* pattern) {
+    /* Only the default layout is compiled in */
+    return (pattern == NULL);
+}
+
+void log_set_timestamp_callback(log_timestamp_callback_t callback) {
+    (void)callback;
+}
+
+#endif /* LOG_NO_LAYOUT */
+
+/**
+ * @brief Format a message and hand it to the output callback
+ *
+ * Shared by log_message() and log_site_message(); level filtering is done
+ * by the callers.
+ */
+static void log_vmessage(log_level_e level, const log_site_t* site,
+                         const char* fmt, va_list args) {
+    log_output_callback_t callback = g_log_ctx.output_callback;
+    log_record_callback_t record_callback = g_log_ctx.record_callback;
+    
+    /* Check if output is configured */
+    if (callback == NULL && record_callback == NULL) {
         return;
     }
     
@@ -360,21 +1376,159 @@ void log_message(log_level_e level, const char* fmt, ...) {
     /* Format message into buffer */
     char buffer[LOG_MAX_MESSAGE_SIZE];
     size_t pos = 0;
+    size_t text_start;
+    size_t text_end;
     
-    /* Format level prefix: "[info] " */
-    pos += format_level_prefix(buffer + pos, sizeof(buffer) - pos, level);
+#ifndef LOG_NO_LAYOUT
+    if (g_log_layout.active) {
+        /* Custom layout: newline only if the pattern has one */
+        pos = format_layout(buffer, sizeof(buffer), level, site, fmt, args,
+                            &text_start, &text_end);
+    } else
+#endif
+    {
+        /* Format level prefix: "[info] " */
+        pos += format_level_prefix(buffer + pos, sizeof(buffer) - pos, level);
+        text_start = pos;
+        
+        /* Append per-thread context: "[tid=3 net] " */
+        pos += format_context_prefix(buffer + pos, sizeof(buffer) - pos);
+        
+        /* Format user message */
+        pos += format_string(buffer + pos, sizeof(buffer) - pos, fmt, args,
+                             g_log_ctx.sanitize);
+        text_end = pos;
+        
+        /* Add newline */
+        if (pos < sizeof(buffer) - 1) {
+            buffer[pos++] = '\n';
+        }
+    }
     
-    /* Format user message */
+    /* Output via callbacks */
+    if (callback != NULL) {
+        callback(buffer, pos);
+    }
+    
+    if (record_callback != NULL) {
+        log_record_t record = {
+            .level = level,
+            .site = site,
+            .message = buffer,
+            .length = pos,
+            .text = buffer + text_start,
+            .text_length = text_end - text_start,
+            .timestamp = 0
+        };
+        record_callback(&record);
+    }
+}
+
+void log_message(log_level_e level, const char* fmt, ...) {
+    /* Runtime filtering: Skip if level exceeds runtime threshold */
+    if (level > g_log_ctx.runtime_level) {
+        return;
+    }
+    
+    va_list args;
+    va_start(args, fmt);
+    log_vmessage(level, NULL, fmt, args);
+    va_end(args);
+}
+
+void log_site_message(const log_site_t* site, const char* fmt, ...) {
+    /* The site's enabled flag already covers runtime level and overrides */
     va_list args;
     va_start(args, fmt);
-    pos += format_string(buffer + pos, sizeof(buffer) - pos, fmt, args);
+    log_vmessage(site->level, site, fmt, args);
     va_end(args);
+}
+
+#ifndef LOG_NO_HEXDUMP
+
+/**
+ * @brief Log a pre-rendered line through the normal message path
+ */
+static void log_emit(log_level_e level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    log_vmessage(level, NULL, fmt, args);
+    va_end(args);
+}
+
+/* Bytes shown per hex dump line */
+#define HEXDUMP_BYTES_PER_LINE 16
+
+void log_hexdump(log_level_e level, const char* label, const void* data,
+                 size_t length) {
+    /* Runtime filtering: Skip if level exceeds runtime threshold */
+    if (level > g_log_ctx.runtime_level) {
+        return;
+    }
     
-    /* Add newline */
-    if (pos < sizeof(buffer) - 1) {
-        buffer[pos++] = '\n';
+    if (!log_is_output_configured() || data == NULL) {
+        return;
     }
     
-    /* Output via callback */
-    g_log_ctx.output_callback(buffer, pos);
+    /* "label 0000001f: 00112233 44556677 8899aabb ccddeeff  |0123456789abcdef|" */
+    char line[LOG_HEXDUMP_LABEL_SIZE + 80];
+    char hex[2 * HEXDUMP_BYTES_PER_LINE];
+    const unsigned char* bytes = data;
+    
+    for (size_t offset = 0; offset < length; offset += HEXDUMP_BYTES_PER_LINE) {
+        size_t count = length - offset;
+        if (count > HEXDUMP_BYTES_PER_LINE) {
+            count = HEXDUMP_BYTES_PER_LINE;
+        }
+        
+        size_t pos = 0;
+        if (label != NULL) {
+            pos += copy_string(label, line, LOG_HEXDUMP_LABEL_SIZE);
+            line[pos++] = ' ';
+        }
+        
+        /* Offset as 8 hex digits, most significant byte first */
+        unsigned char offset_bytes[4] = {
+            (unsigned char)(offset >> 24), (unsigned char)(offset >> 16),
+            (unsigned char)(offset >> 8), (unsigned char)offset
+        };
+        hex_encode(offset_bytes, sizeof(offset_bytes), line + pos);
+        pos += 2 * sizeof(offset_bytes);
+        line[pos++] = ':';
+        
+        /* Hex in groups of 4 bytes, padded so the ASCII column lines up */
+        hex_encode(bytes + offset, count, hex);
+        for (size_t group = 0; group < 2 * HEXDUMP_BYTES_PER_LINE; group += 8) {
+            size_t available = (2 * count > group) ? 2 * count - group : 0;
+            if (available > 8) {
+                available = 8;
+            }
+            line[pos++] = ' ';
+            memcpy(line + pos, hex + group, available);
+            memset(line + pos + available, ' ', 8 - available);
+            pos += 8;
+        }
+        
+        line[pos++] = ' ';
+        line[pos++] = ' ';
+        line[pos++] = '|';
+        hex_ascii(bytes + offset, count, line + pos);
+        pos += count;
+        line[pos++] = '|';
+        line[pos] = '\0';
+        
+        log_emit(level, "%s", line);
+    }
+}
+
+#else /* LOG_NO_HEXDUMP */
+
+void log_hexdump(log_level_e level, const char* label, const void* data,
+                 size_t length) {
+    (void)level;
+    (void)label;
+    (void)data;
+    (void)length;
 }
+
+#endif /* LOG_NO_HEXDUMP */
@@ -34,6 +34,31 @@ typedef enum {
 /* Logging API */
 void log_message(log_level_e l, const char* fmt, ...);
 
+/**
+ * @brief Log a buffer as a multi-line hex dump
+ *
+ * Each line covers 16 bytes and is emitted as its own log message, so
+ * dumps of any size fit in LOG_MAX_MESSAGE_SIZE:
+ * @code
+ * loghexdump(debug, "rx", frame, frame_len);
+ * // [debug] rx 00000000: 45000054 1c464000 4001a0a4 c0a80001  |E..T.F@.@.......|
+ * // [debug] rx 00000010: c0a800c7 0800f7ff                    |........|
+ * @endcode
+ *
+ * For a short buffer inside a single message, use the %*b specifier
+ * instead: loginfo("key: %*b", (int)len, key).
+ *
+ * Builds with LOG_NO_HEXDUMP omit the encoder: this function does nothing
+ * and %*b prints nothing.
+ *
+ * @param l Log level
+ * @param label Text shown at the start of every line, or NULL
+ * @param data Buffer to dump
+ * @param length Number of bytes
+ */
+void log_hexdump(log_level_e l, const char* label, const void* data,
+                 size_t length);
+
 /* Backend API
  *
  * The logging library requires an output callback to send formatted log
@@ -95,7 +120,7 @@ void log_set_output_callback(log_output_callback_t callback);
 /**
  * @brief Check if output callback is configured
  * 
- * @return true if output callback has been set, false otherwise
+ * @return true if an output or record callback has been set, false otherwise
  */
 bool log_is_output_configured(void);
 
@@ -155,10 +180,357 @@ log_level_e log_get_level(void);
  */
 log_level_e log_get_compile_time_level(void);
 
+/* Argument Sanitizing
+ *
+ * %s arguments are copied into messages as they are by default. When they
+ * may come from untrusted input, enable sanitizing so they cannot break
+ * line-oriented log parsing or forge log lines:
+ *
+ * - Newline, carriage return and tab become "\n", "\r" and "\t"
+ * - Other control bytes (0x00..0x1F, 0x7F) become "\xHH"
+ * - Bytes that are not part of well-formed UTF-8 become "\xHH"
+ * - Printable ASCII and well-formed UTF-8 are copied unchanged
+ *
+ * Runs of printable ASCII are located 16 bytes at a time (SSE2/NEON) and
+ * copied with memcpy(), so clean input costs about as much as unsanitized
+ * copying. Only %s arguments are sanitized; format strings and context
+ * fields are trusted. Builds with LOG_NO_SANITIZE omit this code and
+ * log_set_sanitize() has no effect.
+ */
+
+/**
+ * @brief Enable or disable sanitizing of %s arguments (default: disabled)
+ *
+ * @param enabled true to escape control bytes and invalid UTF-8
+ */
+void log_set_sanitize(bool enabled);
+
+/**
+ * @brief Check if %s arguments are sanitized
+ *
+ * @return true if sanitizing is enabled
+ */
+bool log_get_sanitize(void);
+
+/* Per-Thread Context
+ *
+ * Each thread can attach identifying fields (thread id, request id and
+ * component name) to its log messages. The fields are rendered once, when
+ * they are set, into a cached prefix fragment that is copied after the
+ * level prefix of every message logged from that thread:
+ *
+ * @code
+ * log_context_set_thread_id(3);
+ * log_context_set_component("net");
+ * log_context_set_request_id(1042);
+ * loginfo("request accepted");   // "[info] [tid=3 req=1042 net] request accepted"
+ * log_context_clear_request_id();
+ * @endcode
+ *
+ * On hosted OS targets (Unix, macOS, Windows) the context is stored in
+ * thread-local storage (C11 _Thread_local or GNU __thread). On bare-metal
+ * targets, or with LOG_NO_THREAD_LOCAL defined, a single context is shared
+ * by the whole program. Define LOG_THREAD_LOCAL to pick the qualifier
+ * explicitly (e.g. for an RTOS with TLS support).
+ */
+
+/**
+ * @brief Set the thread id shown in this thread's messages
+ *
+ * @param thread_id Thread identifier
+ */
+void log_context_set_thread_id(unsigned int thread_id);
+
+/**
+ * @brief Get the thread id set for the calling thread
+ *
+ * @param thread_id Output thread id (may be NULL)
+ * @return true if a thread id has been set, false otherwise
+ */
+bool log_context_get_thread_id(unsigned int* thread_id);
+
+/**
+ * @brief Set the request id shown in this thread's messages
+ *
+ * @param request_id Request identifier
+ */
+void log_context_set_request_id(unsigned int request_id);
+
+/**
+ * @brief Remove the request id from this thread's messages
+ */
+void log_context_clear_request_id(void);
+
+/**
+ * @brief Set the component name shown in this thread's messages
+ *
+ * The name is copied (and truncated to LOG_CONTEXT_COMPONENT_SIZE - 1
+ * characters), so the caller's string does not need to outlive the call.
+ *
+ * @param component Component name, or NULL to remove it
+ */
+void log_context_set_component(const char* component);
+
+/**
+ * @brief Remove all context fields of the calling thread
+ */
+void log_context_clear(void);
+
+/* Message Layout
+ *
+ * By default every message is rendered as "[level] " followed by the
+ * per-thread context prefix, the formatted message and a newline. A custom
+ * layout replaces that fixed shape. The pattern is compiled once, when it
+ * is set, into a flat list of copy/insert operations, so logging never
+ * re-parses it.
+ *
+ * Layout specifiers:
+ *   %L  level name ("info", "error", ...)
+ *   %T  timestamp from the timestamp callback (nothing if none is set)
+ *   %t  thread id from the per-thread context ("-" if unset)
+ *   %r  request id from the per-thread context ("-" if unset)
+ *   %m  component from the per-thread context ("-" if unset)
+ *   %C  full context prefix, as in the default layout ("[tid=3 net] ")
+ *   %M  the formatted message (at most once)
+ *   %F  source file of the call site ("-" for log_message())
+ *   %l  source line of the call site ("-" for log_message())
+ *   %f  function of the call site ("-" for log_message())
+ *   %%  literal percent sign
+ *
+ * Everything else is copied as is. Unlike the default layout, no newline is
+ * appended implicitly; end the pattern with "\n" to get one.
+ *
+ * @code
+ * log_set_timestamp_callback(my_timestamp);
+ * log_set_layout("%T %L %t [%m] %M\n");   // "12.345 info 3 [net] started\n"
+ * @endcode
+ */
+
+/**
+ * @brief Timestamp callback function type
+ *
+ * Renders the current time, in any format, for the %T layout specifier.
+ *
+ * @param buffer Output buffer
+ * @param size Size of output buffer
+ * @return Number of characters written (at most size)
+ */
+typedef size_t (*log_timestamp_callback_t)(char* buffer, size_t size);
+
+/**
+ * @brief Set the message layout
+ *
+ * The pattern is compiled immediately; on error the current layout is kept.
+ * Like the other configuration calls, do not change the layout while other
+ * threads are logging.
+ *
+ * Builds with LOG_NO_LAYOUT only have the default layout and accept only
+ * NULL.
+ *
+ * @param pattern Layout pattern, or NULL to restore the default layout
+ * @return true on success, false if the pattern has an unknown specifier,
+ *         more than one %M, or exceeds LOG_LAYOUT_MAX_OPS /
+ *         LOG_LAYOUT_MAX_LITERALS
+ */
+bool log_set_layout(const char* pattern);
+
+/**
+ * @brief Set the timestamp callback used by the %T layout specifier
+ *
+ * @param callback Timestamp callback, or NULL to remove it
+ */
+void log_set_timestamp_callback(log_timestamp_callback_t callback);
+
+/* Call-Site Registry
+ *
+ * On ELF targets built with GCC or Clang, every logging macro emits a static
+ * descriptor for its call site into the "log_c_sites" linker section. Each
+ * descriptor carries an `enabled` flag that already accounts for the output
+ * callback, the runtime level and any per-site override, so the check made
+ * at the call site is a single load of that flag.
+ *
+ * Individual sites can be switched on or off at runtime by matching their
+ * file, function or format string against a glob pattern, without touching
+ * the runtime level of any other site:
+ * @code
+ * // Runtime level stays at INFO, but this one function logs debug too
+ * log_site_set(NULL, "parse_header", NULL, LOG_SITE_ON);
+ *
+ * // Silence a noisy line regardless of its level
+ * log_site_set("net.c", NULL, "retry *", LOG_SITE_OFF);
+ *
+ * // Back to level-based filtering for everything
+ * log_site_set(NULL, NULL, NULL, LOG_SITE_DEFAULT);
+ * @endcode
+ *
+ * The format string is stored in the descriptor only when it is a string
+ * literal; calls with a runtime format (e.g. loginfo(msg)) still get a site
+ * with a NULL format, which format globs never match. Define
+ * LOG_NO_SITE_REGISTRY to fall back to plain log_message() calls.
+ */
+
+#if defined(__GNUC__) && defined(__ELF__) && !defined(LOG_NO_SITE_REGISTRY)
+#define LOG_SITE_REGISTRY 1
+#else
+#define LOG_SITE_REGISTRY 0
+#endif
+
+/**
+ * @brief Per-site override mode
+ */
+typedef enum {
+    LOG_SITE_DEFAULT = 0, /**< Follow the runtime log level */
+    LOG_SITE_ON,          /**< Always log (if an output callback is set) */
+    LOG_SITE_OFF          /**< Never log */
+} log_site_mode_e;
+
+/**
+ * @brief Static descriptor of a logging call site
+ *
+ * Instances are created by the logging macros only; use log_site_get() to
+ * inspect them and log_site_set() to change their mode.
+ */
+typedef struct {
+    const char* file;                /**< Source file (__FILE__) */
+    const char* function;            /**< Enclosing function (__func__) */
+    const char* format;              /**< Format string, NULL if not a literal */
+    unsigned int line;               /**< Source line (__LINE__) */
+    log_level_e level;               /**< Level of the message */
+    volatile unsigned char enabled;  /**< Effective state, read by the call site */
+    unsigned char mode;              /**< log_site_mode_e override */
+} log_site_t;
+
+/**
+ * @brief Log a message from a registered call site
+ *
+ * Called by the logging macros once the site's `enabled` flag is set. The
+ * runtime level is not checked again; the flag already reflects it.
+ *
+ * @param site Call-site descriptor
+ * @param fmt Format string (same as site->format)
+ */
+void log_site_message(const log_site_t* site, const char* fmt, ...);
+
+/**
+ * @brief Number of call sites linked into the binary
+ *
+ * @return Number of descriptors in the registry (0 if unsupported)
+ */
+size_t log_site_count(void);
+
+/**
+ * @brief Get a call-site descriptor by index
+ *
+ * @param index Index in [0, log_site_count())
+ * @return Descriptor, or NULL if index is out of range
+ */
+const log_site_t* log_site_get(size_t index);
+
+/**
+ * @brief Set the override mode of all matching call sites
+ *
+ * Patterns are shell-style globs supporting `*` and `?`. A NULL pattern
+ * matches every site. The file pattern is matched against both the full
+ * __FILE__ path and its basename.
+ *
+ * @param file_glob Pattern for the source file, or NULL
+ * @param function_glob Pattern for the function name, or NULL
+ * @param format_glob Pattern for the format string, or NULL
+ * @param mode New override mode for the matching sites
+ * @return Number of sites that matched
+ */
+size_t log_site_set(const char* file_glob, const char* function_glob,
+                    const char* format_glob, log_site_mode_e mode);
+
+/** Site id reported for messages that do not come from a registered site */
+#define LOG_SITE_ID_NONE 0xFFFFFFFFu
+
+/**
+ * @brief Get the stable id of a call site
+ *
+ * The id is the site's index in the registry, so it is stable for a given
+ * binary and can be resolved again with log_site_get().
+ *
+ * @param site Call-site descriptor, or NULL
+ * @return Index of the site, or LOG_SITE_ID_NONE if site is NULL or unknown
+ */
+unsigned int log_site_id(const log_site_t* site);
+
+/* Record API
+ *
+ * Structured sinks (binary files, network forwarders, ...) need more than
+ * the rendered text. A record callback receives every message together with
+ * its level, call site and the offsets of the user text, and may be used
+ * instead of, or in addition to, the output callback.
+ */
+
+/**
+ * @brief A formatted log message with its metadata
+ *
+ * All pointers are only valid during the callback.
+ */
+typedef struct {
+    log_level_e level;          /**< Level of the message */
+    const log_site_t* site;     /**< Call site, or NULL for log_message() */
+    const char* message;        /**< Full line as passed to the output callback */
+    size_t length;              /**< Length of message in bytes */
+    const char* text;           /**< Context prefix and message, without "[level] " tag
+                                     and newline (only the %M part with a layout) */
+    size_t text_length;         /**< Length of text in bytes */
+    unsigned long long timestamp; /**< CLOCK_REALTIME in ns when logged, or 0 for
+                                     "now" (the core leaves it 0; forwarders such
+                                     as logc_collector pass the original time) */
+} log_record_t;
+
+/**
+ * @brief Record callback function type
+ *
+ * Same threading rules as log_output_callback_t.
+ *
+ * @param record Formatted message and metadata
+ */
+typedef void (*log_record_callback_t)(const log_record_t* record);
+
+/**
+ * @brief Set the record callback for log messages
+ *
+ * Called after the output callback (if any) for every message that passes
+ * filtering. Messages are formatted as soon as either callback is set.
+ *
+ * @param callback Record callback function, or NULL to remove it
+ */
+void log_set_record_callback(log_record_callback_t callback);
+
+#if LOG_SITE_REGISTRY
+/* Helper to extract the format string from the macro arguments */
+#define LOG_SITE_FIRST_ARG_(first, ...) first
+
+/* Format for the static descriptor: NULL unless it is a compile-time
+ * constant, so non-literal formats still compile in a static initializer */
+#define LOG_SITE_FORMAT_(fmt)                                                \
+    (__builtin_constant_p(fmt) ? (fmt) : (const char*)0)
+
+#define LOG_SITE_MESSAGE_(lvl, ...)                                          \
+    do {                                                                     \
+        static log_site_t log_site_                                          \
+            __attribute__((section("log_c_sites"), used,                     \
+                           aligned(__alignof__(log_site_t)))) = {            \
+            __FILE__, __func__,                                              \
+            LOG_SITE_FORMAT_(LOG_SITE_FIRST_ARG_(__VA_ARGS__, 0)),           \
+            __LINE__, (lvl), 0, LOG_SITE_DEFAULT                             \
+        };                                                                   \
+        if (log_site_.enabled) {                                             \
+            log_site_message(&log_site_, __VA_ARGS__);                       \
+        }                                                                    \
+    } while (0)
+#else
+#define LOG_SITE_MESSAGE_(lvl, ...) log_message((lvl), __VA_ARGS__)
+#endif
+
 /* Public interface for logging */
 #if LOG_LEVEL >= LOG_LEVEL_CRITICAL
 #ifndef logcritical
-#define logcritical(...) log_message(critical, __VA_ARGS__)
+#define logcritical(...) LOG_SITE_MESSAGE_(critical, __VA_ARGS__)
 #endif
 #else
 #define logcritical(...)
@@ -166,7 +538,7 @@ log_level_e log_get_compile_time_level(void);
 
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
 #ifndef logerror
-#define logerror(...) log_message(error, __VA_ARGS__)
+#define logerror(...) LOG_SITE_MESSAGE_(error, __VA_ARGS__)
 #endif
 #else
 #define logerror(...)
@@ -174,7 +546,7 @@ log_level_e log_get_compile_time_level(void);
 
 #if LOG_LEVEL >= LOG_LEVEL_WARNING
 #ifndef logwarning
-#define logwarning(...) log_message(warning, __VA_ARGS__)
+#define logwarning(...) LOG_SITE_MESSAGE_(warning, __VA_ARGS__)
 #endif
 #else
 #define logwarning(...)
@@ -182,7 +554,7 @@ log_level_e log_get_compile_time_level(void);
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
 #ifndef loginfo
-#define loginfo(...) log_message(info, __VA_ARGS__)
+#define loginfo(...) LOG_SITE_MESSAGE_(info, __VA_ARGS__)
 #endif
 #else
 #define loginfo(...)
@@ -190,10 +562,24 @@ log_level_e log_get_compile_time_level(void);
 
 #if LOG_LEVEL >= LOG_LEVEL_DEBUG
 #ifndef logdebug
-#define logdebug(...) log_message(debug, __VA_ARGS__)
+#define logdebug(...) LOG_SITE_MESSAGE_(debug, __VA_ARGS__)
 #endif
 #else
 #define logdebug(...)
 #endif
 
+/* Hex dumps above the compile-time level are removed by the constant test */
+#if LOG_LEVEL > LOG_LEVEL_OFF
+#ifndef loghexdump
+#define loghexdump(lvl, label, data, length)                                 \
+    do {                                                                     \
+        if ((lvl) <= LOG_LEVEL) {                                            \
+            log_hexdump((lvl), (label), (data), (length));                   \
+        }                                                                    \
+    } while (0)
+#endif
+#else
+#define loghexdump(lvl, label, data, length)
+#endif
+
 #endif /* LOG_C_ */
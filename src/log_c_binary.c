@@ -0,0 +1,252 @@
+/* Indexed binary log sink
+ * Buffers records into blocks and writes each block with its index header
+ * to a file. See log_c_binary.h for the on-disk format.
+ *
+ * Uses stdio, pthreads and clock_gettime().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "log_c_binary.h"
+
+/* Configuration: Maximum payload size of one block in bytes */
+#ifndef LOG_BINARY_BLOCK_SIZE
+#define LOG_BINARY_BLOCK_SIZE (64 * 1024)
+#endif
+
+/*=============================================================================
+ * Sink State
+ *============================================================================*/
+
+/**
+ * @brief Binary sink state (singleton, like the core logging context)
+ */
+typedef struct {
+    pthread_mutex_t lock;                   /**< Serializes writers */
+    FILE* file;                             /**< Open file, NULL if closed */
+    log_binary_block_header_t block;        /**< Index header of the current block */
+    unsigned char payload[LOG_BINARY_BLOCK_SIZE]; /**< Records of the current block */
+} log_binary_sink_t;
+
+static log_binary_sink_t g_binary_sink = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .file = NULL
+};
+
+/**
+ * @brief Current CLOCK_REALTIME in nanoseconds
+ */
+static uint64_t binary_timestamp_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Reset the current block to empty
+ */
+static void binary_block_reset(log_binary_sink_t* sink) {
+    memset(&sink->block, 0, sizeof(sink->block));
+    sink->block.magic = LOG_BINARY_BLOCK_MAGIC;
+}
+
+/**
+ * @brief Write the current block (if not empty) and start a new one
+ * @return true on success
+ */
+static bool binary_block_write(log_binary_sink_t* sink) {
+    bool ok = true;
+
+    if (sink->block.record_count == 0) {
+        return true;
+    }
+
+    if (fwrite(&sink->block, sizeof(sink->block), 1, sink->file) != 1 ||
+        fwrite(sink->payload, 1, sink->block.payload_size, sink->file) !=
+            sink->block.payload_size) {
+        ok = false;
+    }
+
+    binary_block_reset(sink);
+    return ok;
+}
+
+/**
+ * @brief Clamp a string length to the 16-bit length fields of the format
+ */
+static uint16_t binary_string_length(const char* str) {
+    size_t len = (str != NULL) ? strlen(str) : 0;
+    return (uint16_t)(len > UINT16_MAX ? UINT16_MAX : len);
+}
+
+/**
+ * @brief Write the file header and the call-site table
+ * @return true on success
+ */
+static bool binary_write_header(FILE* file) {
+    log_binary_file_header_t header;
+    size_t count = log_site_count();
+    uint32_t table_size = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const log_site_t* site = log_site_get(i);
+        table_size += (uint32_t)sizeof(log_binary_site_entry_t) +
+                      binary_string_length(site->file) +
+                      binary_string_length(site->function) +
+                      binary_string_length(site->format);
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC));
+    header.version = LOG_BINARY_VERSION;
+    header.byte_order = LOG_BINARY_BYTE_ORDER;
+    header.site_count = (uint32_t)count;
+    header.site_table_size = table_size;
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const log_site_t* site = log_site_get(i);
+        log_binary_site_entry_t entry;
+
+        memset(&entry, 0, sizeof(entry));
+        entry.line = site->line;
+        entry.level = (uint8_t)site->level;
+        entry.file_length = binary_string_length(site->file);
+        entry.function_length = binary_string_length(site->function);
+        entry.format_length = binary_string_length(site->format);
+
+        if (fwrite(&entry, sizeof(entry), 1, file) != 1 ||
+            fwrite(site->file, 1, entry.file_length, file) != entry.file_length ||
+            fwrite(site->function, 1, entry.function_length, file) != entry.function_length ||
+            fwrite(site->format, 1, entry.format_length, file) != entry.format_length) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*=============================================================================
+ * Sink API
+ *============================================================================*/
+
+bool log_binary_sink_open(const char* path) {
+    log_binary_sink_t* sink = &g_binary_sink;
+    bool ok = false;
+
+    if (path == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->file == NULL) {
+        FILE* file = fopen(path, "wb");
+        if (file != NULL) {
+            if (binary_write_header(file)) {
+                sink->file = file;
+                binary_block_reset(sink);
+                ok = true;
+            } else {
+                fclose(file);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+    return ok;
+}
+
+void log_binary_sink_record(const log_record_t* record) {
+    log_binary_sink_t* sink = &g_binary_sink;
+    log_binary_record_header_t header;
+
+    if (record == NULL) {
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.timestamp = (record->timestamp != 0) ? record->timestamp
+                                                : binary_timestamp_now();
+    header.site_id = log_site_id(record->site);
+    header.level = (uint8_t)record->level;
+    header.length = (uint16_t)(record->text_length > UINT16_MAX ?
+                               UINT16_MAX : record->text_length);
+
+    size_t size = sizeof(header) + header.length;
+    if (size > sizeof(sink->payload)) {
+        header.length = (uint16_t)(sizeof(sink->payload) - sizeof(header));
+        size = sizeof(sink->payload);
+    }
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->file == NULL) {
+        pthread_mutex_unlock(&sink->lock);
+        return;
+    }
+
+    if (sink->block.payload_size + size > sizeof(sink->payload)) {
+        binary_block_write(sink);
+    }
+
+    /* Update the block's index entry */
+    log_binary_block_header_t* block = &sink->block;
+    if (block->record_count == 0 || header.timestamp < block->first_timestamp) {
+        block->first_timestamp = header.timestamp;
+    }
+    if (header.timestamp > block->last_timestamp) {
+        block->last_timestamp = header.timestamp;
+    }
+    block->level_mask |= (1u << (header.level & 31u));
+    block->site_mask |= ((uint64_t)1 << (header.site_id & 63u));
+    block->record_count++;
+
+    /* Append header and text to the payload */
+    memcpy(sink->payload + block->payload_size, &header, sizeof(header));
+    memcpy(sink->payload + block->payload_size + sizeof(header),
+           record->text, header.length);
+    block->payload_size += (uint32_t)size;
+
+    pthread_mutex_unlock(&sink->lock);
+}
+
+bool log_binary_sink_flush(void) {
+    log_binary_sink_t* sink = &g_binary_sink;
+    bool ok = false;
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->file != NULL) {
+        ok = binary_block_write(sink);
+        ok = (fflush(sink->file) == 0) && ok;
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+    return ok;
+}
+
+bool log_binary_sink_close(void) {
+    log_binary_sink_t* sink = &g_binary_sink;
+    bool ok = false;
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->file != NULL) {
+        ok = binary_block_write(sink);
+        ok = (fclose(sink->file) == 0) && ok;
+        sink->file = NULL;
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+    return ok;
+}
@@ -0,0 +1,135 @@
+#ifndef LOG_C_BINARY_
+#define LOG_C_BINARY_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "log_c.h"
+
+/* Indexed Binary Log Sink
+ *
+ * Writes log records into a compact binary file that can be searched
+ * without scanning every message. Records are grouped into blocks; each
+ * block starts with a small index header holding its time range, a mask
+ * of the levels it contains and a coarse mask of its call-site ids, so a
+ * reader can skip whole blocks that cannot match a query.
+ *
+ * The sink is driven by the record callback:
+ * @code
+ * log_binary_sink_open("app.logb");
+ * log_set_record_callback(log_binary_sink_record);
+ * ...
+ * log_binary_sink_close();
+ * @endcode
+ *
+ * Use the logc_query tool (tools/logc_query.c) to filter and render a file
+ * back to the usual "[level] message" text.
+ *
+ * Records are buffered in memory until a block is full, so call
+ * log_binary_sink_flush() at points where the file must be complete.
+ * Depends on stdio, pthreads and clock_gettime().
+ */
+
+/*=============================================================================
+ * On-Disk Format
+ *
+ * All integers are stored in the byte order of the writer; readers check
+ * byte_order in the file header.
+ *
+ *   file header   log_binary_file_header_t
+ *   site table    site_count x (log_binary_site_entry_t + file, function
+ *                 and format strings, not null-terminated)
+ *   blocks        repeated until end of file:
+ *                   log_binary_block_header_t
+ *                   record_count x (log_binary_record_header_t + text)
+ *============================================================================*/
+
+#define LOG_BINARY_MAGIC       "LOGCBIN"   /**< 7 chars + null = 8 bytes */
+#define LOG_BINARY_VERSION     1u
+#define LOG_BINARY_BYTE_ORDER  0x01020304u
+#define LOG_BINARY_BLOCK_MAGIC 0x4B4C4243u /**< "CBLK" when little-endian */
+
+/** @brief File header, at offset 0 */
+typedef struct {
+    char magic[8];              /**< LOG_BINARY_MAGIC */
+    uint32_t version;           /**< LOG_BINARY_VERSION */
+    uint32_t byte_order;        /**< LOG_BINARY_BYTE_ORDER as written */
+    uint32_t site_count;        /**< Number of site table entries */
+    uint32_t site_table_size;   /**< Size of the site table in bytes */
+} log_binary_file_header_t;
+
+/** @brief Site table entry, followed by its three strings */
+typedef struct {
+    uint32_t line;              /**< Source line */
+    uint8_t level;              /**< Level of the site */
+    uint8_t reserved;
+    uint16_t file_length;       /**< Length of the file string */
+    uint16_t function_length;   /**< Length of the function string */
+    uint16_t format_length;     /**< Length of the format string */
+} log_binary_site_entry_t;
+
+/** @brief Block header: the sparse index entry of one block */
+typedef struct {
+    uint32_t magic;             /**< LOG_BINARY_BLOCK_MAGIC */
+    uint32_t record_count;      /**< Number of records in the block */
+    uint32_t payload_size;      /**< Bytes of records following the header */
+    uint32_t level_mask;        /**< Bit (1 << level) set for each level present */
+    uint64_t site_mask;         /**< Bit (site_id % 64) set for each site present */
+    uint64_t first_timestamp;   /**< Earliest record timestamp (ns since epoch) */
+    uint64_t last_timestamp;    /**< Latest record timestamp (ns since epoch) */
+} log_binary_block_header_t;
+
+/** @brief Record header, followed by length bytes of text */
+typedef struct {
+    uint64_t timestamp;         /**< CLOCK_REALTIME in ns since epoch */
+    uint32_t site_id;           /**< log_site_id() or LOG_SITE_ID_NONE */
+    uint16_t length;            /**< Text length in bytes */
+    uint8_t level;              /**< log_level_e */
+    uint8_t reserved;
+} log_binary_record_header_t;
+
+/*=============================================================================
+ * Sink API
+ *============================================================================*/
+
+/**
+ * @brief Open (truncate) a binary log file and write its header
+ *
+ * The current call-site registry is written into the file so that site ids
+ * can be resolved without the binary that produced them.
+ *
+ * @param path File path
+ * @return true on success, false if the file could not be created or a
+ *         sink is already open
+ */
+bool log_binary_sink_open(const char* path);
+
+/**
+ * @brief Record callback that appends a record to the open file
+ *
+ * Pass to log_set_record_callback(). Safe to call from several threads.
+ * Records are dropped if no file is open.
+ *
+ * @param record Record to append
+ */
+void log_binary_sink_record(const log_record_t* record);
+
+/**
+ * @brief Write the current partial block to the file
+ *
+ * @return true on success, false on I/O error or if no file is open
+ */
+bool log_binary_sink_flush(void);
+
+/**
+ * @brief Flush and close the file
+ *
+ * Does not remove the record callback; records logged afterwards are
+ * dropped until a new file is opened.
+ *
+ * @return true on success, false on I/O error or if no file is open
+ */
+bool log_binary_sink_close(void);
+
+#endif /* LOG_C_BINARY_ */
@@ -0,0 +1,457 @@
+/* Batched UDP / syslog network sink
+ * Packs formatted records into MTU-sized datagrams and sends queued
+ * datagrams in batches with sendmmsg(). See log_c_net.h for the API.
+ *
+ * Uses BSD sockets, sendmmsg(), getaddrinfo(), pthreads and stdio
+ * formatting.
+ */
+
+#define _GNU_SOURCE /* sendmmsg() */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "log_c_net.h"
+
+/* Configuration: Largest datagram payload (Ethernet MTU - IPv4/UDP headers) */
+#ifndef LOG_NET_MAX_DATAGRAM
+#define LOG_NET_MAX_DATAGRAM 1472
+#endif
+
+/* Configuration: Number of datagrams queued before a batch send */
+#ifndef LOG_NET_BATCH_SIZE
+#define LOG_NET_BATCH_SIZE 16
+#endif
+
+/* Default time a message may wait in the queue */
+#define LOG_NET_DEFAULT_FLUSH_MS 100u
+
+/* Syslog facility "user" */
+#define LOG_NET_DEFAULT_FACILITY 1u
+
+/*=============================================================================
+ * Sink State
+ *============================================================================*/
+
+/**
+ * @brief Network sink state
+ *
+ * Datagrams [0, count) are complete; datagrams[count] is being filled.
+ */
+typedef struct {
+    pthread_mutex_t lock;                   /**< Protects everything below */
+    pthread_cond_t wakeup;                  /**< Signals the flusher thread */
+    pthread_t flusher;                      /**< Periodic flusher thread */
+    int socket_fd;                          /**< Connected UDP socket, -1 if closed */
+    bool stopping;                          /**< Flusher should exit */
+    log_net_framing_e framing;              /**< Message framing */
+    size_t mtu;                             /**< Datagram payload limit */
+    unsigned int facility;                  /**< RFC 5424 facility */
+    unsigned long flush_interval_ns;        /**< Max queueing time */
+    unsigned long long oldest_ns;           /**< Queue time of oldest pending message */
+    char header_suffix[384];                /**< Pre-rendered " HOST APP PROCID - - " */
+    size_t count;                           /**< Number of complete datagrams */
+    size_t lengths[LOG_NET_BATCH_SIZE];     /**< Payload length per datagram */
+    unsigned long messages_in[LOG_NET_BATCH_SIZE]; /**< Messages per datagram */
+    char datagrams[LOG_NET_BATCH_SIZE][LOG_NET_MAX_DATAGRAM]; /**< Payloads */
+    log_net_stats_t stats;                  /**< Counters */
+} log_net_sink_t;
+
+static log_net_sink_t g_net_sink = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .socket_fd = -1
+};
+
+static unsigned long long net_monotonic_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000u + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * @brief Map a log level to a syslog severity
+ */
+static unsigned int net_severity(log_level_e level) {
+    switch (level) {
+        case LOG_LEVEL_CRITICAL: return 2;
+        case LOG_LEVEL_ERROR:    return 3;
+        case LOG_LEVEL_WARNING:  return 4;
+        case LOG_LEVEL_INFO:     return 6;
+        case LOG_LEVEL_DEBUG:    return 7;
+        default:                 return 5;
+    }
+}
+
+/**
+ * @brief Render a record into its framed form
+ * @return Length of the framed message (always newline-terminated)
+ */
+static size_t net_render(const log_net_sink_t* sink, const log_record_t* record,
+                         char* buffer, size_t buf_size) {
+    size_t pos = 0;
+
+    if (sink->framing == LOG_NET_FRAMING_RFC5424) {
+        struct timespec ts;
+        struct tm tm;
+
+        if (record->timestamp != 0) {
+            ts.tv_sec = (time_t)(record->timestamp / 1000000000u);
+            ts.tv_nsec = (long)(record->timestamp % 1000000000u);
+        } else {
+            clock_gettime(CLOCK_REALTIME, &ts);
+        }
+        gmtime_r(&ts.tv_sec, &tm);
+
+        int n = snprintf(buffer, buf_size,
+                         "<%u>1 %04d-%02d-%02dT%02d:%02d:%02d.%06ldZ%s",
+                         sink->facility * 8u + net_severity(record->level),
+                         tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                         tm.tm_hour, tm.tm_min, tm.tm_sec,
+                         (long)(ts.tv_nsec / 1000), sink->header_suffix);
+        if (n < 0) {
+            return 0;
+        }
+        pos = ((size_t)n < buf_size) ? (size_t)n : buf_size - 1;
+
+        size_t text_length = record->text_length;
+        if (text_length > buf_size - 1 - pos) {
+            text_length = buf_size - 1 - pos;
+        }
+        memcpy(buffer + pos, record->text, text_length);
+        pos += text_length;
+    } else {
+        size_t length = record->length;
+
+        /* Drop the newline added by the core; it is re-added below */
+        if (length > 0 && record->message[length - 1] == '\n') {
+            length--;
+        }
+        if (length > buf_size - 1) {
+            length = buf_size - 1;
+        }
+        memcpy(buffer, record->message, length);
+        pos = length;
+    }
+
+    buffer[pos++] = '\n';
+    return pos;
+}
+
+/**
+ * @brief Send every pending datagram, including the partial one
+ *
+ * Must be called with the lock held.
+ *
+ * @return true if all datagrams were accepted by the kernel
+ */
+static bool net_send_pending(log_net_sink_t* sink) {
+    struct iovec iov[LOG_NET_BATCH_SIZE];
+    size_t n = sink->count;
+    bool ok = true;
+
+    if (n < LOG_NET_BATCH_SIZE && sink->lengths[n] > 0) {
+        n++;
+    }
+    if (n == 0) {
+        return true;
+    }
+
+#if defined(__linux__)
+    struct mmsghdr msgs[LOG_NET_BATCH_SIZE];
+    memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < n; i++) {
+        iov[i].iov_base = sink->datagrams[i];
+        iov[i].iov_len = sink->lengths[i];
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t i = 0;
+    while (i < n) {
+        int sent = sendmmsg(sink->socket_fd, &msgs[i], (unsigned int)(n - i),
+                            MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            /* Drop the datagram the kernel refused and go on */
+            sink->stats.datagrams_dropped++;
+            sink->stats.messages_dropped += sink->messages_in[i];
+            ok = false;
+            i++;
+            continue;
+        }
+        for (int j = 0; j < sent; j++, i++) {
+            sink->stats.datagrams_sent++;
+            sink->stats.bytes_sent += sink->lengths[i];
+        }
+    }
+#else
+    for (size_t i = 0; i < n; i++) {
+        ssize_t sent;
+
+        iov[i].iov_base = sink->datagrams[i];
+        iov[i].iov_len = sink->lengths[i];
+        do {
+            sent = send(sink->socket_fd, iov[i].iov_base, iov[i].iov_len,
+                        MSG_DONTWAIT);
+        } while (sent < 0 && errno == EINTR);
+
+        if (sent < 0) {
+            sink->stats.datagrams_dropped++;
+            sink->stats.messages_dropped += sink->messages_in[i];
+            ok = false;
+        } else {
+            sink->stats.datagrams_sent++;
+            sink->stats.bytes_sent += (unsigned long)sent;
+        }
+    }
+#endif
+
+    memset(sink->lengths, 0, sizeof(sink->lengths));
+    memset(sink->messages_in, 0, sizeof(sink->messages_in));
+    sink->count = 0;
+    return ok;
+}
+
+/**
+ * @brief Periodic flusher: sends the queue once its oldest message has
+ *        waited for the flush interval
+ */
+static void* net_flusher_main(void* arg) {
+    log_net_sink_t* sink = arg;
+
+    pthread_mutex_lock(&sink->lock);
+
+    while (!sink->stopping) {
+        bool pending = (sink->count > 0 || sink->lengths[0] > 0);
+
+        if (!pending) {
+            pthread_cond_wait(&sink->wakeup, &sink->lock);
+            continue;
+        }
+
+        unsigned long long deadline = sink->oldest_ns + sink->flush_interval_ns;
+        if (net_monotonic_ns() >= deadline) {
+            net_send_pending(sink);
+            continue;
+        }
+
+        struct timespec ts;
+        ts.tv_sec = (time_t)(deadline / 1000000000u);
+        ts.tv_nsec = (long)(deadline % 1000000000u);
+        pthread_cond_timedwait(&sink->wakeup, &sink->lock, &ts);
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+    return NULL;
+}
+
+/**
+ * @brief Create a non-blocking UDP socket connected to host:port
+ * @return Socket descriptor, or -1 on error
+ */
+static int net_connect(const char* host, unsigned short port) {
+    struct addrinfo hints;
+    struct addrinfo* result;
+    char service[8];
+    int fd = -1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    snprintf(service, sizeof(service), "%u", (unsigned int)port);
+
+    if (getaddrinfo(host, service, &hints, &result) != 0) {
+        return -1;
+    }
+
+    for (struct addrinfo* ai = result; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(result);
+    return fd;
+}
+
+/*=============================================================================
+ * Sink API
+ *============================================================================*/
+
+bool log_net_sink_open(const log_net_config_t* config) {
+    log_net_sink_t* sink = &g_net_sink;
+    pthread_condattr_t attr;
+    char hostname[256];
+
+    if (config == NULL || config->host == NULL || config->port == 0) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->socket_fd >= 0) {
+        pthread_mutex_unlock(&sink->lock);
+        return false;
+    }
+
+    int fd = net_connect(config->host, config->port);
+    if (fd < 0) {
+        pthread_mutex_unlock(&sink->lock);
+        return false;
+    }
+
+    sink->framing = config->framing;
+    sink->mtu = (config->mtu == 0 || config->mtu > LOG_NET_MAX_DATAGRAM) ?
+                LOG_NET_MAX_DATAGRAM : config->mtu;
+    sink->facility = (config->facility == 0 || config->facility > 23) ?
+                     LOG_NET_DEFAULT_FACILITY : config->facility;
+    sink->flush_interval_ns = 1000000ul * ((config->flush_interval_ms == 0) ?
+                              LOG_NET_DEFAULT_FLUSH_MS : config->flush_interval_ms);
+
+    /* Everything after the timestamp is fixed for the process lifetime */
+    if (config->hostname != NULL) {
+        snprintf(hostname, sizeof(hostname), "%s", config->hostname);
+    } else if (gethostname(hostname, sizeof(hostname)) != 0 || hostname[0] == '\0') {
+        snprintf(hostname, sizeof(hostname), "-");
+    }
+    hostname[sizeof(hostname) - 1] = '\0';
+    snprintf(sink->header_suffix, sizeof(sink->header_suffix),
+             " %.255s %.48s %ld - - ", hostname,
+             (config->app_name != NULL) ? config->app_name : "-",
+             (long)getpid());
+
+    sink->count = 0;
+    memset(sink->lengths, 0, sizeof(sink->lengths));
+    memset(sink->messages_in, 0, sizeof(sink->messages_in));
+    sink->stopping = false;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sink->wakeup, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&sink->flusher, NULL, net_flusher_main, sink) != 0) {
+        pthread_cond_destroy(&sink->wakeup);
+        close(fd);
+        pthread_mutex_unlock(&sink->lock);
+        return false;
+    }
+
+    sink->socket_fd = fd;
+    pthread_mutex_unlock(&sink->lock);
+    return true;
+}
+
+void log_net_sink_record(const log_record_t* record) {
+    log_net_sink_t* sink = &g_net_sink;
+    char message[LOG_NET_MAX_DATAGRAM];
+
+    if (record == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->socket_fd < 0) {
+        sink->stats.messages_dropped++;
+        pthread_mutex_unlock(&sink->lock);
+        return;
+    }
+
+    size_t length = net_render(sink, record, message, sink->mtu);
+
+    /* Start a new datagram if this message does not fit the current one */
+    if (sink->lengths[sink->count] + length > sink->mtu) {
+        sink->count++;
+        if (sink->count == LOG_NET_BATCH_SIZE) {
+            net_send_pending(sink);
+        }
+    }
+
+    bool was_empty = (sink->count == 0 && sink->lengths[0] == 0);
+
+    memcpy(sink->datagrams[sink->count] + sink->lengths[sink->count], message, length);
+    sink->lengths[sink->count] += length;
+    sink->messages_in[sink->count]++;
+    sink->stats.messages++;
+
+    if (was_empty) {
+        sink->oldest_ns = net_monotonic_ns();
+        pthread_cond_signal(&sink->wakeup);
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+}
+
+bool log_net_sink_flush(void) {
+    log_net_sink_t* sink = &g_net_sink;
+    bool ok = false;
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->socket_fd >= 0) {
+        ok = net_send_pending(sink);
+    }
+
+    pthread_mutex_unlock(&sink->lock);
+    return ok;
+}
+
+void log_net_sink_close(void) {
+    log_net_sink_t* sink = &g_net_sink;
+
+    pthread_mutex_lock(&sink->lock);
+
+    if (sink->socket_fd < 0) {
+        pthread_mutex_unlock(&sink->lock);
+        return;
+    }
+
+    net_send_pending(sink);
+    sink->stopping = true;
+    pthread_cond_signal(&sink->wakeup);
+    pthread_mutex_unlock(&sink->lock);
+
+    pthread_join(sink->flusher, NULL);
+
+    pthread_mutex_lock(&sink->lock);
+    net_send_pending(sink); /* Records queued while the flusher was stopping */
+    close(sink->socket_fd);
+    sink->socket_fd = -1;
+    pthread_cond_destroy(&sink->wakeup);
+    pthread_mutex_unlock(&sink->lock);
+}
+
+void log_net_sink_get_stats(log_net_stats_t* stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_net_sink.lock);
+    *stats = g_net_sink.stats;
+    pthread_mutex_unlock(&g_net_sink.lock);
+}
+
+void log_net_sink_reset_stats(void) {
+    pthread_mutex_lock(&g_net_sink.lock);
+    memset(&g_net_sink.stats, 0, sizeof(g_net_sink.stats));
+    pthread_mutex_unlock(&g_net_sink.lock);
+}
@@ -0,0 +1,118 @@
+#ifndef LOG_C_NET_
+#define LOG_C_NET_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "log_c.h"
+
+/* Batched UDP / Syslog Network Sink
+ *
+ * Forwards log records to a collector over UDP. Instead of sending one
+ * datagram per message, records are packed back to back (one per line)
+ * into datagrams of at most `mtu` bytes. Full datagrams are queued and
+ * sent together with a single sendmmsg() call once the queue is full,
+ * when log_net_sink_flush() is called, or when the oldest queued message
+ * is older than the flush interval.
+ *
+ * The socket is non-blocking: when the kernel cannot take a datagram
+ * (socket buffer full, collector unreachable) it is dropped and counted in
+ * log_net_stats_t instead of stalling the logging thread.
+ *
+ * @code
+ * log_net_config_t config = {
+ *     .host = "127.0.0.1",
+ *     .port = 514,
+ *     .framing = LOG_NET_FRAMING_RFC5424,
+ *     .app_name = "myapp",
+ * };
+ * log_net_sink_open(&config);
+ * log_set_record_callback(log_net_sink_record);
+ * @endcode
+ *
+ * Depends on BSD sockets and pthreads.
+ */
+
+/**
+ * @brief Per-message framing inside a datagram
+ *
+ * Both framings terminate each message with a newline.
+ */
+typedef enum {
+    LOG_NET_FRAMING_NEWLINE = 0, /**< The plain "[level] message" line */
+    LOG_NET_FRAMING_RFC5424      /**< "<PRI>1 TIMESTAMP HOST APP PROCID - - message" */
+} log_net_framing_e;
+
+/**
+ * @brief Network sink configuration
+ *
+ * Zero-initialized fields select the defaults.
+ */
+typedef struct {
+    const char* host;               /**< Collector address or name (required) */
+    unsigned short port;            /**< Collector UDP port (required) */
+    log_net_framing_e framing;      /**< Message framing */
+    size_t mtu;                     /**< Max datagram payload (default/max LOG_NET_MAX_DATAGRAM) */
+    unsigned int flush_interval_ms; /**< Max time a message waits (default 100 ms) */
+    unsigned int facility;          /**< Syslog facility for RFC 5424 (default 1, user) */
+    const char* app_name;           /**< RFC 5424 APP-NAME (default "-") */
+    const char* hostname;           /**< RFC 5424 HOSTNAME (default gethostname()) */
+} log_net_config_t;
+
+/**
+ * @brief Network sink counters
+ */
+typedef struct {
+    unsigned long messages;           /**< Messages accepted by the sink */
+    unsigned long messages_dropped;   /**< Messages lost (send failure or sink closed) */
+    unsigned long datagrams_sent;     /**< Datagrams handed to the kernel */
+    unsigned long datagrams_dropped;  /**< Datagrams rejected by the kernel */
+    unsigned long bytes_sent;         /**< Payload bytes handed to the kernel */
+} log_net_stats_t;
+
+/**
+ * @brief Open the UDP socket and start the periodic flusher
+ *
+ * @param config Sink configuration
+ * @return true on success, false on invalid configuration, socket or
+ *         thread error, or if the sink is already open
+ */
+bool log_net_sink_open(const log_net_config_t* config);
+
+/**
+ * @brief Record callback that queues a record for sending
+ *
+ * Pass to log_set_record_callback(). Safe to call from several threads.
+ *
+ * @param record Record to send
+ */
+void log_net_sink_record(const log_record_t* record);
+
+/**
+ * @brief Send all queued messages now
+ *
+ * @return true if every queued datagram was accepted by the kernel
+ */
+bool log_net_sink_flush(void);
+
+/**
+ * @brief Flush, stop the flusher thread and close the socket
+ */
+void log_net_sink_close(void);
+
+/**
+ * @brief Get a snapshot of the sink counters
+ *
+ * Counters are kept across close/open and reset only by
+ * log_net_sink_reset_stats().
+ *
+ * @param stats Output counters
+ */
+void log_net_sink_get_stats(log_net_stats_t* stats);
+
+/**
+ * @brief Reset all sink counters to zero
+ */
+void log_net_sink_reset_stats(void);
+
+#endif /* LOG_C_NET_ */
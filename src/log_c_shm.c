@@ -0,0 +1,496 @@
+/* Shared-memory log rings
+ * One POSIX shared-memory segment holds a header and a fixed number of
+ * rings, one per attached producer process. See log_c_shm.h for the API.
+ *
+ * Each ring is a bounded multi-producer / single-consumer queue of
+ * fixed-size cells. Every cell carries a sequence number: a producer
+ * reserves a position with a CAS on the enqueue counter, fills the cell and
+ * publishes it by storing position + 1 into its sequence; the collector
+ * consumes cells whose sequence says they are published and hands them back
+ * by storing position + ring size. No lock is ever taken, so a producer
+ * that dies mid-write cannot block the others or the collector.
+ *
+ * Uses shm_open(), mmap(), kill() and GCC/Clang atomic builtins on the
+ * shared mapping.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "log_c_shm.h"
+
+/* Configuration: Number of producer rings in the segment */
+#ifndef LOG_SHM_MAX_PRODUCERS
+#define LOG_SHM_MAX_PRODUCERS 64
+#endif
+
+/* Configuration: Cells per ring (must be a power of two) */
+#ifndef LOG_SHM_RING_ENTRIES
+#define LOG_SHM_RING_ENTRIES 256
+#endif
+
+/* Configuration: Maximum message bytes stored per cell */
+#ifndef LOG_SHM_MESSAGE_SIZE
+#define LOG_SHM_MESSAGE_SIZE 256
+#endif
+
+#if (LOG_SHM_RING_ENTRIES & (LOG_SHM_RING_ENTRIES - 1)) != 0
+#error "LOG_SHM_RING_ENTRIES must be a power of two"
+#endif
+
+#define LOG_SHM_MAGIC   0x53474F4Cu /* "LOGS" little-endian */
+#define LOG_SHM_VERSION 1u
+#define LOG_SHM_CACHE_LINE 64
+
+/*=============================================================================
+ * Segment Layout
+ *============================================================================*/
+
+/** @brief Ring slot states */
+enum {
+    SHM_SLOT_FREE = 0,      /**< Available for log_shm_attach() */
+    SHM_SLOT_ACTIVE,        /**< Owned by a live (or presumed live) producer */
+    SHM_SLOT_DETACHED       /**< Released by its producer, awaiting final drain */
+};
+
+/** @brief One fixed-size message cell */
+typedef struct {
+    uint64_t sequence;                  /**< Publication state (see file comment) */
+    uint64_t timestamp;                 /**< CLOCK_REALTIME in ns */
+    uint16_t length;                    /**< Bytes used in message */
+    uint16_t text_offset;               /**< Offset of the text in message */
+    uint16_t text_length;               /**< Length of the text */
+    uint8_t level;                      /**< log_level_e */
+    uint8_t reserved;
+    char message[LOG_SHM_MESSAGE_SIZE]; /**< Rendered message */
+} shm_cell_t;
+
+/**
+ * @brief One producer ring
+ *
+ * The enqueue counter (written by producers) and the dequeue counter
+ * (written by the collector) live on separate cache lines.
+ */
+typedef struct {
+    uint32_t state;                     /**< SHM_SLOT_* */
+    int32_t pid;                        /**< Owner process, 0 while claiming */
+    uint64_t dropped;                   /**< Messages lost to a full ring */
+    uint8_t pad0[LOG_SHM_CACHE_LINE - 16];
+    uint64_t enqueue_position;          /**< Next position to reserve */
+    uint8_t pad1[LOG_SHM_CACHE_LINE - 8];
+    uint64_t dequeue_position;          /**< Next position to consume */
+    uint8_t pad2[LOG_SHM_CACHE_LINE - 8];
+    shm_cell_t cells[LOG_SHM_RING_ENTRIES];
+} shm_ring_t;
+
+/**
+ * @brief Segment header
+ *
+ * The geometry fields let producers built with different configuration
+ * macros refuse to attach instead of corrupting the segment.
+ */
+typedef struct {
+    uint32_t magic;                     /**< LOG_SHM_MAGIC once initialized */
+    uint32_t version;                   /**< LOG_SHM_VERSION */
+    uint32_t max_producers;             /**< LOG_SHM_MAX_PRODUCERS */
+    uint32_t ring_entries;              /**< LOG_SHM_RING_ENTRIES */
+    uint32_t cell_size;                 /**< sizeof(shm_cell_t) */
+    uint8_t pad[LOG_SHM_CACHE_LINE - 20];
+    shm_ring_t rings[LOG_SHM_MAX_PRODUCERS];
+} shm_segment_t;
+
+/*=============================================================================
+ * State
+ *============================================================================*/
+
+/**
+ * @brief Producer and collector mappings (singleton)
+ *
+ * A process may be both (the tests are), in which case it maps the segment
+ * twice.
+ */
+typedef struct {
+    shm_segment_t* producer_segment;    /**< Mapping used by log_shm_record() */
+    shm_ring_t* producer_ring;          /**< Claimed ring, NULL if not attached */
+    shm_segment_t* collector_segment;   /**< Mapping used by log_shm_collect() */
+} log_shm_state_t;
+
+static log_shm_state_t g_shm = {
+    .producer_segment = NULL,
+    .producer_ring = NULL,
+    .collector_segment = NULL
+};
+
+static uint64_t shm_timestamp_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Check that a mapped segment was initialized with our geometry
+ */
+static bool shm_segment_compatible(const shm_segment_t* segment) {
+    return __atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) == LOG_SHM_MAGIC &&
+           segment->version == LOG_SHM_VERSION &&
+           segment->max_producers == LOG_SHM_MAX_PRODUCERS &&
+           segment->ring_entries == LOG_SHM_RING_ENTRIES &&
+           segment->cell_size == sizeof(shm_cell_t);
+}
+
+/**
+ * @brief Empty a ring and mark every cell free for position = index
+ *
+ * Only called while no producer can write to the ring.
+ */
+static void shm_ring_reset(shm_ring_t* ring) {
+    for (uint64_t i = 0; i < LOG_SHM_RING_ENTRIES; i++) {
+        ring->cells[i].sequence = i;
+    }
+    ring->enqueue_position = 0;
+    ring->dequeue_position = 0;
+    ring->dropped = 0;
+    ring->pid = 0;
+}
+
+/**
+ * @brief Map a segment file descriptor
+ * @return Mapping, or NULL on failure
+ */
+static shm_segment_t* shm_map(int fd) {
+    void* mapping = mmap(NULL, sizeof(shm_segment_t), PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+
+    return (mapping == MAP_FAILED) ? NULL : (shm_segment_t*)mapping;
+}
+
+/*=============================================================================
+ * Producer API
+ *============================================================================*/
+
+bool log_shm_attach(const char* name) {
+    struct stat st;
+
+    if (name == NULL || g_shm.producer_ring != NULL) {
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    shm_segment_t* segment = NULL;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size == sizeof(shm_segment_t)) {
+        segment = shm_map(fd);
+    }
+    close(fd);
+
+    if (segment == NULL) {
+        return false;
+    }
+    if (!shm_segment_compatible(segment)) {
+        munmap(segment, sizeof(*segment));
+        return false;
+    }
+
+    for (size_t i = 0; i < LOG_SHM_MAX_PRODUCERS; i++) {
+        shm_ring_t* ring = &segment->rings[i];
+        uint32_t expected = SHM_SLOT_FREE;
+
+        /* Free rings were reset by the collector; claiming one only needs
+         * the state CAS. The pid follows, so the collector treats pid 0 as
+         * "still claiming" and never reaps it. */
+        if (__atomic_compare_exchange_n(&ring->state, &expected, SHM_SLOT_ACTIVE,
+                                        false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&ring->pid, (int32_t)getpid(), __ATOMIC_RELEASE);
+            g_shm.producer_segment = segment;
+            g_shm.producer_ring = ring;
+            return true;
+        }
+    }
+
+    munmap(segment, sizeof(*segment));
+    return false;
+}
+
+void log_shm_record(const log_record_t* record) {
+    shm_ring_t* ring = g_shm.producer_ring;
+
+    if (ring == NULL || record == NULL) {
+        return;
+    }
+
+    uint64_t position = __atomic_load_n(&ring->enqueue_position, __ATOMIC_RELAXED);
+    shm_cell_t* cell;
+
+    for (;;) {
+        cell = &ring->cells[position & (LOG_SHM_RING_ENTRIES - 1)];
+        uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(sequence - position);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueue_position, &position,
+                                            position + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Cell still holds a message from one lap ago: ring is full */
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            position = __atomic_load_n(&ring->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    size_t length = record->length;
+    if (length > LOG_SHM_MESSAGE_SIZE) {
+        length = LOG_SHM_MESSAGE_SIZE;
+    }
+    size_t text_offset = (size_t)(record->text - record->message);
+    if (text_offset > length) {
+        text_offset = length;
+    }
+    size_t text_length = record->text_length;
+    if (text_length > length - text_offset) {
+        text_length = length - text_offset;
+    }
+
+    cell->timestamp = (record->timestamp != 0) ? record->timestamp
+                                               : shm_timestamp_now();
+    cell->length = (uint16_t)length;
+    cell->text_offset = (uint16_t)text_offset;
+    cell->text_length = (uint16_t)text_length;
+    cell->level = (uint8_t)record->level;
+    memcpy(cell->message, record->message, length);
+
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+void log_shm_detach(void) {
+    shm_ring_t* ring = g_shm.producer_ring;
+
+    if (ring == NULL) {
+        return;
+    }
+
+    g_shm.producer_ring = NULL;
+    __atomic_store_n(&ring->state, SHM_SLOT_DETACHED, __ATOMIC_RELEASE);
+
+    munmap(g_shm.producer_segment, sizeof(shm_segment_t));
+    g_shm.producer_segment = NULL;
+}
+
+/*=============================================================================
+ * Collector API
+ *============================================================================*/
+
+bool log_shm_create(const char* name) {
+    struct stat st;
+
+    if (name == NULL || g_shm.collector_segment != NULL) {
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    /* A compatible segment left by a previous collector is adopted as is,
+     * so producers stay attached and queued messages are not lost. */
+    bool adopt = fstat(fd, &st) == 0 && (size_t)st.st_size == sizeof(shm_segment_t);
+    if (!adopt && ftruncate(fd, (off_t)sizeof(shm_segment_t)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    shm_segment_t* segment = shm_map(fd);
+    close(fd);
+    if (segment == NULL) {
+        return false;
+    }
+
+    if (!adopt || !shm_segment_compatible(segment)) {
+        __atomic_store_n(&segment->magic, 0, __ATOMIC_RELEASE);
+        segment->version = LOG_SHM_VERSION;
+        segment->max_producers = LOG_SHM_MAX_PRODUCERS;
+        segment->ring_entries = LOG_SHM_RING_ENTRIES;
+        segment->cell_size = sizeof(shm_cell_t);
+        for (size_t i = 0; i < LOG_SHM_MAX_PRODUCERS; i++) {
+            shm_ring_reset(&segment->rings[i]);
+            segment->rings[i].state = SHM_SLOT_FREE;
+        }
+        /* Producers refuse to attach until the magic is published */
+        __atomic_store_n(&segment->magic, LOG_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    g_shm.collector_segment = segment;
+    return true;
+}
+
+/**
+ * @brief Check whether a producer process still exists
+ *
+ * A pid that was reused by an unrelated process looks alive; its ring is
+ * then reclaimed only once that process exits too.
+ */
+static bool shm_producer_alive(int32_t pid) {
+    if (pid <= 0) {
+        return true;
+    }
+    return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+}
+
+/**
+ * @brief Find the next published cell of a ring
+ *
+ * In a ring whose producer is gone, reserved cells that were never
+ * published (the process died while filling them) are skipped.
+ *
+ * @param orphaned true if no producer can write to the ring any more
+ * @return Cell, or NULL if none is ready
+ */
+static shm_cell_t* shm_ring_peek(shm_ring_t* ring, bool orphaned) {
+    uint64_t position = ring->dequeue_position;
+
+    for (;;) {
+        shm_cell_t* cell = &ring->cells[position & (LOG_SHM_RING_ENTRIES - 1)];
+        uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == position + 1) {
+            return cell;
+        }
+        if (!orphaned ||
+            position >= __atomic_load_n(&ring->enqueue_position, __ATOMIC_ACQUIRE)) {
+            return NULL;
+        }
+
+        position++;
+        ring->dequeue_position = position;
+    }
+}
+
+/**
+ * @brief Hand the cell at the dequeue position back to producers
+ */
+static void shm_ring_pop(shm_ring_t* ring, shm_cell_t* cell) {
+    uint64_t position = ring->dequeue_position;
+
+    ring->dequeue_position = position + 1;
+    __atomic_store_n(&cell->sequence, position + LOG_SHM_RING_ENTRIES, __ATOMIC_RELEASE);
+}
+
+size_t log_shm_collect(log_shm_handler_t handler) {
+    shm_segment_t* segment = g_shm.collector_segment;
+    bool orphaned[LOG_SHM_MAX_PRODUCERS];
+    size_t collected = 0;
+
+    if (segment == NULL) {
+        return 0;
+    }
+
+    /* Decide liveness once, before draining: a ring judged orphaned is
+     * drained completely and then freed in the same pass. */
+    for (size_t i = 0; i < LOG_SHM_MAX_PRODUCERS; i++) {
+        shm_ring_t* ring = &segment->rings[i];
+        uint32_t state = __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE);
+
+        orphaned[i] = state == SHM_SLOT_DETACHED ||
+                      (state == SHM_SLOT_ACTIVE &&
+                       !shm_producer_alive(__atomic_load_n(&ring->pid, __ATOMIC_ACQUIRE)));
+    }
+
+    /* Merge: repeatedly emit the oldest ready message across all rings */
+    for (;;) {
+        shm_ring_t* oldest_ring = NULL;
+        shm_cell_t* oldest_cell = NULL;
+
+        for (size_t i = 0; i < LOG_SHM_MAX_PRODUCERS; i++) {
+            shm_ring_t* ring = &segment->rings[i];
+
+            if (__atomic_load_n(&ring->state, __ATOMIC_ACQUIRE) == SHM_SLOT_FREE) {
+                continue;
+            }
+
+            shm_cell_t* cell = shm_ring_peek(ring, orphaned[i]);
+            if (cell != NULL &&
+                (oldest_cell == NULL || cell->timestamp < oldest_cell->timestamp)) {
+                oldest_ring = ring;
+                oldest_cell = cell;
+            }
+        }
+
+        if (oldest_cell == NULL) {
+            break;
+        }
+
+        if (handler != NULL) {
+            log_shm_message_t message = {
+                .timestamp = oldest_cell->timestamp,
+                .pid = (int)oldest_ring->pid,
+                .level = (log_level_e)oldest_cell->level,
+                .message = oldest_cell->message,
+                .length = oldest_cell->length,
+                .text = oldest_cell->message + oldest_cell->text_offset,
+                .text_length = oldest_cell->text_length
+            };
+            handler(&message);
+        }
+
+        shm_ring_pop(oldest_ring, oldest_cell);
+        collected++;
+    }
+
+    for (size_t i = 0; i < LOG_SHM_MAX_PRODUCERS; i++) {
+        if (orphaned[i]) {
+            shm_ring_t* ring = &segment->rings[i];
+
+            shm_ring_reset(ring);
+            __atomic_store_n(&ring->state, SHM_SLOT_FREE, __ATOMIC_RELEASE);
+        }
+    }
+
+    return collected;
+}
+
+bool log_shm_get_producer_stats(size_t index, log_shm_producer_stats_t* stats) {
+    shm_segment_t* segment = g_shm.collector_segment;
+
+    if (segment == NULL || stats == NULL || index >= LOG_SHM_MAX_PRODUCERS) {
+        return false;
+    }
+
+    shm_ring_t* ring = &segment->rings[index];
+    uint32_t state = __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE);
+
+    stats->pid = (state == SHM_SLOT_FREE) ? 0 : (int)ring->pid;
+    stats->active = state == SHM_SLOT_ACTIVE;
+    stats->dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    return true;
+}
+
+size_t log_shm_max_producers(void) {
+    return LOG_SHM_MAX_PRODUCERS;
+}
+
+void log_shm_destroy(const char* name) {
+    if (g_shm.collector_segment != NULL) {
+        munmap(g_shm.collector_segment, sizeof(shm_segment_t));
+        g_shm.collector_segment = NULL;
+    }
+    if (name != NULL) {
+        shm_unlink(name);
+    }
+}
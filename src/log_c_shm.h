@@ -0,0 +1,160 @@
+#ifndef LOG_C_SHM_
+#define LOG_C_SHM_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "log_c.h"
+
+/* Shared-Memory Log Rings
+ *
+ * Lets many processes on one host hand their log messages to a single
+ * collector without doing any I/O themselves. A collector creates a POSIX
+ * shared-memory segment holding one ring per producer process; each
+ * producer claims a ring on attach and its record callback copies messages
+ * into it with a lock-free multi-producer enqueue (threads of one process
+ * share its ring). The collector drains all rings, merges them by
+ * timestamp and writes them to the real sinks (see tools/logc_collector.c).
+ *
+ * Messages are in shared memory as soon as they are logged, so the last
+ * messages of a crashed worker are still collected. When a producer
+ * detaches, or the collector finds that its process no longer exists, the
+ * ring is drained and returned to the free pool.
+ *
+ * Producer:
+ * @code
+ * if (log_shm_attach("/logc")) {
+ *     log_set_record_callback(log_shm_record);
+ * }
+ * ...
+ * log_shm_detach();
+ * @endcode
+ *
+ * Collector:
+ * @code
+ * log_shm_create("/logc");
+ * for (;;) {
+ *     log_shm_collect(handle_message);
+ *     usleep(10000);
+ * }
+ * @endcode
+ *
+ * A full ring drops the new message and counts it; a producer never
+ * blocks. Depends on shm_open(), mmap() and GCC/Clang atomics.
+ */
+
+/**
+ * @brief A message read from a producer ring
+ *
+ * Pointers are only valid during the handler call.
+ */
+typedef struct {
+    unsigned long long timestamp;   /**< CLOCK_REALTIME in ns when logged */
+    int pid;                        /**< Producer process id */
+    log_level_e level;              /**< Level of the message */
+    const char* message;            /**< Full line as rendered by the producer */
+    size_t length;                  /**< Length of message in bytes */
+    const char* text;               /**< Message without "[level] " tag and newline */
+    size_t text_length;             /**< Length of text in bytes */
+} log_shm_message_t;
+
+/**
+ * @brief Collector handler function type
+ *
+ * @param message Message read from a ring
+ */
+typedef void (*log_shm_handler_t)(const log_shm_message_t* message);
+
+/**
+ * @brief Per-producer counters, as seen by the collector
+ */
+typedef struct {
+    int pid;                        /**< Producer process id (0 if slot unused) */
+    bool active;                    /**< Slot is attached */
+    unsigned long long dropped;     /**< Messages dropped because the ring was full */
+} log_shm_producer_stats_t;
+
+/*=============================================================================
+ * Producer API
+ *============================================================================*/
+
+/**
+ * @brief Attach the calling process to a collector's segment
+ *
+ * Claims a free ring in the segment created by log_shm_create().
+ *
+ * @param name Segment name (e.g. "/logc")
+ * @return true on success, false if the segment does not exist, is
+ *         incompatible, has no free ring, or this process is already attached
+ */
+bool log_shm_attach(const char* name);
+
+/**
+ * @brief Record callback that copies a record into this process's ring
+ *
+ * Pass to log_set_record_callback(). Lock-free and safe to call from
+ * several threads. Messages longer than LOG_SHM_MESSAGE_SIZE are truncated.
+ *
+ * @param record Record to enqueue
+ */
+void log_shm_record(const log_record_t* record);
+
+/**
+ * @brief Release this process's ring
+ *
+ * Messages already enqueued are still collected. Stop logging through
+ * log_shm_record() before calling this.
+ */
+void log_shm_detach(void);
+
+/*=============================================================================
+ * Collector API
+ *============================================================================*/
+
+/**
+ * @brief Create (or re-initialize) the shared-memory segment
+ *
+ * @param name Segment name (e.g. "/logc")
+ * @return true on success
+ */
+bool log_shm_create(const char* name);
+
+/**
+ * @brief Drain all rings, merged in timestamp order
+ *
+ * Also reclaims rings of producers that detached or whose process no
+ * longer exists, after draining their remaining messages.
+ *
+ * @param handler Called for each message
+ * @return Number of messages passed to the handler
+ */
+size_t log_shm_collect(log_shm_handler_t handler);
+
+/**
+ * @brief Get the counters of a producer slot
+ *
+ * @param index Slot index in [0, log_shm_max_producers())
+ * @param stats Output counters
+ * @return true if index is valid and a segment is open
+ */
+bool log_shm_get_producer_stats(size_t index, log_shm_producer_stats_t* stats);
+
+/**
+ * @brief Number of producer slots in the segment
+ *
+ * @return Slot count (LOG_SHM_MAX_PRODUCERS)
+ */
+size_t log_shm_max_producers(void);
+
+/**
+ * @brief Unmap the segment, and remove it if a name is given
+ *
+ * With NULL the segment stays in place and a later log_shm_create() adopts
+ * it with everything still queued. Once removed, producers still attached
+ * keep their mapping but are no longer collected.
+ *
+ * @param name Segment name passed to log_shm_create(), or NULL to keep it
+ */
+void log_shm_destroy(const char* name);
+
+#endif /* LOG_C_SHM_ */
@@ -0,0 +1,287 @@
+/* Tracing spans with Chrome trace-event export
+ * Each thread records completed spans into its own buffer; buffers are
+ * linked into a global list once, on the thread's first span, so the
+ * exporter can walk them. See log_c_trace.h for the API.
+ *
+ * Uses pthreads, clock_gettime(), malloc() and stdio formatting.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "log_c_trace.h"
+
+/* Configuration: Completed spans kept per thread */
+#ifndef LOG_TRACE_BUFFER_EVENTS
+#define LOG_TRACE_BUFFER_EVENTS 4096
+#endif
+
+/* Configuration: Maximum nesting depth of open spans per thread */
+#ifndef LOG_TRACE_MAX_DEPTH
+#define LOG_TRACE_MAX_DEPTH 32
+#endif
+
+/*=============================================================================
+ * Per-Thread Buffers
+ *============================================================================*/
+
+/** @brief One completed span */
+typedef struct {
+    const char* name;           /**< Span name */
+    uint64_t begin_ns;          /**< CLOCK_MONOTONIC at begin */
+    uint64_t end_ns;            /**< CLOCK_MONOTONIC at end */
+    unsigned int thread_id;     /**< Thread id at end */
+} trace_event_t;
+
+/**
+ * @brief Span buffer of one thread
+ *
+ * Only the owning thread writes events; `count` is published with release
+ * semantics so the exporter can read completed events concurrently.
+ */
+typedef struct trace_buffer {
+    struct trace_buffer* next;                  /**< Next registered buffer */
+    unsigned int fallback_thread_id;            /**< Used if the context has no thread id */
+    unsigned int depth;                         /**< Number of open spans */
+    const char* open_names[LOG_TRACE_MAX_DEPTH];/**< Names of open spans */
+    uint64_t open_begin[LOG_TRACE_MAX_DEPTH];   /**< Begin times of open spans */
+    size_t count;                               /**< Completed events */
+    unsigned long dropped;                      /**< Spans not recorded */
+    trace_event_t events[LOG_TRACE_BUFFER_EVENTS]; /**< Completed events */
+} trace_buffer_t;
+
+/**
+ * @brief Tracing state (singleton)
+ */
+typedef struct {
+    volatile bool enabled;          /**< Runtime switch */
+    pthread_mutex_t lock;           /**< Protects the buffer list */
+    trace_buffer_t* buffers;        /**< Registered thread buffers */
+    unsigned int next_thread_id;    /**< Fallback id of the next buffer */
+} trace_state_t;
+
+static trace_state_t g_trace = {
+    .enabled = false,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .buffers = NULL,
+    .next_thread_id = 1
+};
+
+static __thread trace_buffer_t* t_trace_buffer;
+
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Get (or allocate and register) the calling thread's buffer
+ *
+ * Buffers are never freed, so the exporter can still read the spans of
+ * threads that have exited.
+ *
+ * @return Buffer, or NULL if allocation failed
+ */
+static trace_buffer_t* trace_thread_buffer(void) {
+    trace_buffer_t* buffer = t_trace_buffer;
+
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    buffer = calloc(1, sizeof(*buffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&g_trace.lock);
+    buffer->fallback_thread_id = g_trace.next_thread_id++;
+    buffer->next = g_trace.buffers;
+    g_trace.buffers = buffer;
+    pthread_mutex_unlock(&g_trace.lock);
+
+    t_trace_buffer = buffer;
+    return buffer;
+}
+
+/*=============================================================================
+ * Span API
+ *============================================================================*/
+
+void log_trace_set_enabled(bool enabled) {
+    g_trace.enabled = enabled;
+}
+
+bool log_trace_is_enabled(void) {
+    return g_trace.enabled;
+}
+
+log_span_t log_span_begin(const char* name) {
+    if (!g_trace.enabled) {
+        return 0;
+    }
+
+    trace_buffer_t* buffer = trace_thread_buffer();
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    if (buffer->depth >= LOG_TRACE_MAX_DEPTH) {
+        buffer->dropped++;
+        return 0;
+    }
+
+    buffer->open_names[buffer->depth] = name;
+    buffer->open_begin[buffer->depth] = trace_now_ns();
+    buffer->depth++;
+
+    /* Handle is the 1-based depth, so mismatched ends can be detected */
+    return buffer->depth;
+}
+
+void log_span_end(log_span_t span) {
+    trace_buffer_t* buffer = t_trace_buffer;
+
+    if (span == 0 || buffer == NULL || span != buffer->depth) {
+        return;
+    }
+
+    uint64_t end_ns = trace_now_ns();
+    buffer->depth--;
+
+    size_t count = buffer->count;
+    if (count >= LOG_TRACE_BUFFER_EVENTS) {
+        buffer->dropped++;
+        return;
+    }
+
+    trace_event_t* event = &buffer->events[count];
+    event->name = buffer->open_names[buffer->depth];
+    event->begin_ns = buffer->open_begin[buffer->depth];
+    event->end_ns = end_ns;
+    if (!log_context_get_thread_id(&event->thread_id)) {
+        event->thread_id = buffer->fallback_thread_id;
+    }
+
+    __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+}
+
+void log_span_end_scope(log_span_t* span) {
+    log_span_end(*span);
+}
+
+/*=============================================================================
+ * Export
+ *============================================================================*/
+
+/**
+ * @brief Write a span name as a JSON string body (without quotes)
+ * @return Number of characters written
+ */
+static size_t trace_json_escape(const char* str, char* buffer, size_t buf_size) {
+    static const char hex_chars[] = "0123456789abcdef";
+    size_t pos = 0;
+
+    for (; str != NULL && *str != '\0'; str++) {
+        unsigned char c = (unsigned char)*str;
+
+        if (pos + 6 >= buf_size) {
+            break;
+        }
+        if (c == '"' || c == '\\') {
+            buffer[pos++] = '\\';
+            buffer[pos++] = (char)c;
+        } else if (c < 0x20) {
+            memcpy(buffer + pos, "\\u00", 4);
+            buffer[pos + 4] = hex_chars[c >> 4];
+            buffer[pos + 5] = hex_chars[c & 0x0F];
+            pos += 6;
+        } else {
+            buffer[pos++] = (char)c;
+        }
+    }
+
+    return pos;
+}
+
+void log_trace_export(log_output_callback_t writer) {
+    char name[128];
+    char line[256];
+    bool first = true;
+    long pid = (long)getpid();
+
+    if (writer == NULL) {
+        return;
+    }
+
+    static const char header[] = "{\"traceEvents\":[";
+    writer(header, sizeof(header) - 1);
+
+    pthread_mutex_lock(&g_trace.lock);
+
+    for (trace_buffer_t* buffer = g_trace.buffers; buffer != NULL;
+         buffer = buffer->next) {
+        size_t count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+
+        for (size_t i = 0; i < count; i++) {
+            const trace_event_t* event = &buffer->events[i];
+            uint64_t duration = event->end_ns - event->begin_ns;
+            size_t name_length = trace_json_escape(event->name, name, sizeof(name));
+
+            /* Trace-event timestamps are microseconds */
+            int n = snprintf(line, sizeof(line),
+                             "%s\n{\"name\":\"%.*s\",\"ph\":\"X\",\"ts\":%llu.%03u,"
+                             "\"dur\":%llu.%03u,\"pid\":%ld,\"tid\":%u}",
+                             first ? "" : ",", (int)name_length, name,
+                             (unsigned long long)(event->begin_ns / 1000u),
+                             (unsigned int)(event->begin_ns % 1000u),
+                             (unsigned long long)(duration / 1000u),
+                             (unsigned int)(duration % 1000u),
+                             pid, event->thread_id);
+            if (n > 0) {
+                writer(line, ((size_t)n < sizeof(line)) ? (size_t)n : sizeof(line) - 1);
+                first = false;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&g_trace.lock);
+
+    static const char footer[] = "\n],\"displayTimeUnit\":\"ns\"}\n";
+    writer(footer, sizeof(footer) - 1);
+}
+
+void log_trace_reset(void) {
+    pthread_mutex_lock(&g_trace.lock);
+
+    for (trace_buffer_t* buffer = g_trace.buffers; buffer != NULL;
+         buffer = buffer->next) {
+        __atomic_store_n(&buffer->count, 0, __ATOMIC_RELEASE);
+        buffer->dropped = 0;
+    }
+
+    pthread_mutex_unlock(&g_trace.lock);
+}
+
+unsigned long log_trace_dropped(void) {
+    unsigned long dropped = 0;
+
+    pthread_mutex_lock(&g_trace.lock);
+
+    for (trace_buffer_t* buffer = g_trace.buffers; buffer != NULL;
+         buffer = buffer->next) {
+        dropped += buffer->dropped;
+    }
+
+    pthread_mutex_unlock(&g_trace.lock);
+    return dropped;
+}
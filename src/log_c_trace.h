@@ -0,0 +1,126 @@
+#ifndef LOG_C_TRACE_
+#define LOG_C_TRACE_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "log_c.h"
+
+/* Tracing Spans
+ *
+ * Lightweight scope-based spans as a replacement for bracketing functions
+ * with logdebug("enter") / logdebug("exit"). Each span records its begin
+ * and end timestamps and the thread id (from the per-thread context) into
+ * a buffer owned by the recording thread, so no lock is taken on the hot
+ * path. Recorded spans are exported as Chrome / Perfetto trace-event JSON
+ * through a writer of the same type as the output callback:
+ *
+ * @code
+ * void parse_request(void) {
+ *     logspan("parse_request");   // ends when the enclosing scope exits
+ *     ...
+ * }
+ *
+ * log_trace_set_enabled(true);
+ * parse_request();
+ * log_trace_export(write_to_trace_file);   // load in ui.perfetto.dev
+ * @endcode
+ *
+ * Spans are compiled in only when LOG_LEVEL >= LOG_TRACE_LEVEL (default
+ * LOG_LEVEL_DEBUG); otherwise logspan() expands to nothing. When compiled
+ * in but disabled at runtime, a span costs two calls that return after
+ * checking one flag.
+ *
+ * Span names are stored by pointer and must outlive the export (string
+ * literals are the intended use). Depends on pthreads, clock_gettime()
+ * and malloc().
+ */
+
+#ifndef LOG_TRACE_LEVEL
+/** Minimum compile-time LOG_LEVEL at which logspan() is compiled in */
+#define LOG_TRACE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * @brief Handle of an open span
+ *
+ * Zero if the span is not being recorded.
+ */
+typedef unsigned int log_span_t;
+
+/**
+ * @brief Enable or disable span recording at runtime (default: disabled)
+ *
+ * @param enabled true to record spans
+ */
+void log_trace_set_enabled(bool enabled);
+
+/**
+ * @brief Check if span recording is enabled
+ *
+ * @return true if spans are being recorded
+ */
+bool log_trace_is_enabled(void);
+
+/**
+ * @brief Open a span on the calling thread
+ *
+ * Spans must be closed in reverse order of opening (they nest).
+ *
+ * @param name Span name (string literal or other static string)
+ * @return Handle to pass to log_span_end()
+ */
+log_span_t log_span_begin(const char* name);
+
+/**
+ * @brief Close a span opened with log_span_begin()
+ *
+ * @param span Handle returned by log_span_begin()
+ */
+void log_span_end(log_span_t span);
+
+/**
+ * @brief Cleanup handler used by logspan(); not meant to be called directly
+ */
+void log_span_end_scope(log_span_t* span);
+
+/**
+ * @brief Export all recorded spans as Chrome trace-event JSON
+ *
+ * The JSON document is written in pieces through the writer. Threads may
+ * keep recording during the export; spans completed after it started may
+ * or may not be included.
+ *
+ * @param writer Receives consecutive chunks of the JSON document
+ */
+void log_trace_export(log_output_callback_t writer);
+
+/**
+ * @brief Discard all recorded spans
+ *
+ * Must not run concurrently with recording threads.
+ */
+void log_trace_reset(void);
+
+/**
+ * @brief Number of spans lost because a buffer was full or nesting too deep
+ *
+ * @return Dropped span count since start or the last log_trace_reset()
+ */
+unsigned long log_trace_dropped(void);
+
+/* Public interface for spans */
+#if LOG_LEVEL >= LOG_TRACE_LEVEL && defined(__GNUC__)
+#define LOG_SPAN_CONCAT_(a, b) a##b
+#define LOG_SPAN_VAR_(line) LOG_SPAN_CONCAT_(log_span_, line)
+#ifndef logspan
+#define logspan(name)                                                        \
+    log_span_t LOG_SPAN_VAR_(__LINE__)                                       \
+        __attribute__((cleanup(log_span_end_scope), unused)) =              \
+        log_span_begin(name)
+#endif
+#else
+#define logspan(name) ((void)0)
+#endif
+
+#endif /* LOG_C_TRACE_ */
@@ -0,0 +1,168 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "unity.h"
+#include "log_c.h"
+#include "log_c_binary.h"
+
+static const char* test_path = "TestBinarySink.logb";
+
+static unsigned char* file_data;
+static size_t file_size;
+
+static void load_file(void) {
+    FILE* file = fopen(test_path, "rb");
+
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, 0, SEEK_END);
+    file_size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    file_data = malloc(file_size);
+    TEST_ASSERT_EQUAL(file_size, fread(file_data, 1, file_size, file));
+    fclose(file);
+}
+
+void setUp(void) {
+    file_data = NULL;
+    file_size = 0;
+    log_set_level(LOG_LEVEL_INFO);
+    log_set_record_callback(log_binary_sink_record);
+}
+
+void tearDown(void) {
+    log_set_record_callback(NULL);
+    log_binary_sink_close();
+    free(file_data);
+    remove(test_path);
+}
+
+void test_BinarySink_HeaderAndSiteTable(void) {
+    log_binary_file_header_t header;
+    log_binary_site_entry_t entry;
+
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+    TEST_ASSERT_TRUE(log_binary_sink_close());
+    load_file();
+
+    TEST_ASSERT_GREATER_OR_EQUAL(sizeof(header), file_size);
+    memcpy(&header, file_data, sizeof(header));
+    TEST_ASSERT_EQUAL_STRING(LOG_BINARY_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL(LOG_BINARY_VERSION, header.version);
+    TEST_ASSERT_EQUAL(LOG_BINARY_BYTE_ORDER, header.byte_order);
+    TEST_ASSERT_EQUAL(log_site_count(), header.site_count);
+    TEST_ASSERT_EQUAL(sizeof(header) + header.site_table_size, file_size);
+
+    /* First entry matches the first registered site */
+    const log_site_t* site = log_site_get(0);
+    memcpy(&entry, file_data + sizeof(header), sizeof(entry));
+    TEST_ASSERT_EQUAL(site->line, entry.line);
+    TEST_ASSERT_EQUAL(site->level, entry.level);
+    TEST_ASSERT_EQUAL(strlen(site->format), entry.format_length);
+}
+
+void test_BinarySink_RecordsAndBlockIndex(void) {
+    log_binary_file_header_t header;
+    log_binary_block_header_t block;
+    log_binary_record_header_t record;
+
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+    loginfo("value %d", 42);
+    logerror("failed");
+    logdebug("suppressed");
+    TEST_ASSERT_TRUE(log_binary_sink_close());
+    load_file();
+
+    memcpy(&header, file_data, sizeof(header));
+    size_t pos = sizeof(header) + header.site_table_size;
+
+    memcpy(&block, file_data + pos, sizeof(block));
+    pos += sizeof(block);
+    TEST_ASSERT_EQUAL(LOG_BINARY_BLOCK_MAGIC, block.magic);
+    TEST_ASSERT_EQUAL(2, block.record_count);
+    TEST_ASSERT_EQUAL((1u << info) | (1u << error), block.level_mask);
+    TEST_ASSERT_LESS_OR_EQUAL(block.last_timestamp, block.first_timestamp);
+    TEST_ASSERT_EQUAL(file_size, pos + block.payload_size);
+
+    memcpy(&record, file_data + pos, sizeof(record));
+    pos += sizeof(record);
+    TEST_ASSERT_EQUAL(info, record.level);
+    TEST_ASSERT_EQUAL(strlen("value 42"), record.length);
+    TEST_ASSERT_EQUAL_MEMORY("value 42", file_data + pos, record.length);
+    TEST_ASSERT_EQUAL_STRING("value %d", log_site_get(record.site_id)->format);
+    TEST_ASSERT_GREATER_OR_EQUAL(block.first_timestamp, record.timestamp);
+    pos += record.length;
+
+    memcpy(&record, file_data + pos, sizeof(record));
+    pos += sizeof(record);
+    TEST_ASSERT_EQUAL(error, record.level);
+    TEST_ASSERT_EQUAL_MEMORY("failed", file_data + pos, record.length);
+}
+
+void test_BinarySink_DirectLogMessageHasNoSite(void) {
+    log_binary_file_header_t header;
+    log_binary_record_header_t record;
+
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+    log_message(warning, "direct");
+    TEST_ASSERT_TRUE(log_binary_sink_close());
+    load_file();
+
+    memcpy(&header, file_data, sizeof(header));
+    size_t pos = sizeof(header) + header.site_table_size +
+                 sizeof(log_binary_block_header_t);
+    memcpy(&record, file_data + pos, sizeof(record));
+    TEST_ASSERT_EQUAL(LOG_SITE_ID_NONE, record.site_id);
+}
+
+void test_BinarySink_SplitsIntoBlocks(void) {
+    log_binary_file_header_t header;
+    log_binary_block_header_t block;
+    unsigned int blocks = 0;
+    unsigned int records = 0;
+
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+    for (int i = 0; i < 5000; i++) {
+        loginfo("a fairly long message used to fill several blocks: %d", i);
+    }
+    TEST_ASSERT_TRUE(log_binary_sink_close());
+    load_file();
+
+    memcpy(&header, file_data, sizeof(header));
+    size_t pos = sizeof(header) + header.site_table_size;
+    while (pos < file_size) {
+        memcpy(&block, file_data + pos, sizeof(block));
+        TEST_ASSERT_EQUAL(LOG_BINARY_BLOCK_MAGIC, block.magic);
+        pos += sizeof(block) + block.payload_size;
+        records += block.record_count;
+        blocks++;
+    }
+
+    TEST_ASSERT_EQUAL(file_size, pos);
+    TEST_ASSERT_EQUAL(5000, records);
+    TEST_ASSERT_GREATER_THAN(1, blocks);
+}
+
+void test_BinarySink_ClosedSinkDropsRecords(void) {
+    TEST_ASSERT_FALSE(log_binary_sink_flush());
+    loginfo("dropped");
+    TEST_ASSERT_FALSE(log_binary_sink_close());
+}
+
+void test_BinarySink_OpenTwiceFails(void) {
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+    TEST_ASSERT_FALSE(log_binary_sink_open(test_path));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_BinarySink_HeaderAndSiteTable);
+    RUN_TEST(test_BinarySink_RecordsAndBlockIndex);
+    RUN_TEST(test_BinarySink_DirectLogMessageHasNoSite);
+    RUN_TEST(test_BinarySink_SplitsIntoBlocks);
+    RUN_TEST(test_BinarySink_ClosedSinkDropsRecords);
+    RUN_TEST(test_BinarySink_OpenTwiceFails);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+#include <string.h>
+
+/* Compile every level in so that debug sites exist in the registry */
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "unity.h"
+#include "log_c.h"
+
+static char capture_buffer[512];
+static size_t capture_length;
+static int capture_count;
+
+static void mock_output_callback(const char* message, size_t length) {
+    if (length < sizeof(capture_buffer)) {
+        memcpy(capture_buffer, message, length);
+        capture_length = length;
+        capture_buffer[length] = '\0';
+    }
+    capture_count++;
+}
+
+static void verbose_path(void) {
+    logdebug("verbose path value %d", 7);
+}
+
+static void quiet_path(void) {
+    logdebug("quiet path value %d", 8);
+}
+
+static void noisy_info(void) {
+    loginfo("retry attempt %u", 3);
+}
+
+/* Runtime (non-literal) formats must keep compiling with the registry */
+static void runtime_format(const char* message) {
+    loginfo(message);
+}
+
+void setUp(void) {
+    capture_length = 0;
+    capture_count = 0;
+    capture_buffer[0] = '\0';
+    log_set_output_callback(mock_output_callback);
+    log_set_level(LOG_LEVEL_INFO);
+    log_site_set(NULL, NULL, NULL, LOG_SITE_DEFAULT);
+}
+
+void tearDown(void) {
+    log_set_output_callback(NULL);
+}
+
+void test_CallSites_RegistryEnumeratesSites(void) {
+    size_t count = log_site_count();
+    bool found = false;
+
+    TEST_ASSERT_GREATER_OR_EQUAL(3, count);
+
+    for (size_t i = 0; i < count; i++) {
+        const log_site_t* site = log_site_get(i);
+        TEST_ASSERT_NOT_NULL(site);
+        if (strcmp(site->function, "verbose_path") == 0) {
+            TEST_ASSERT_EQUAL_STRING("verbose path value %d", site->format);
+            TEST_ASSERT_NOT_NULL(strstr(site->file, "TestCallSites.c"));
+            TEST_ASSERT_EQUAL(debug, site->level);
+            found = true;
+        }
+    }
+
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_NULL(log_site_get(count));
+}
+
+void test_CallSites_DebugSuppressedByDefault(void) {
+    verbose_path();
+
+    TEST_ASSERT_EQUAL(0, capture_count);
+}
+
+void test_CallSites_EnableByFunction(void) {
+    TEST_ASSERT_EQUAL(1, log_site_set(NULL, "verbose_*", NULL, LOG_SITE_ON));
+
+    verbose_path();
+    TEST_ASSERT_EQUAL(1, capture_count);
+    TEST_ASSERT_EQUAL_STRING("[debug] verbose path value 7\n", capture_buffer);
+
+    /* Other debug sites keep following the runtime level */
+    quiet_path();
+    TEST_ASSERT_EQUAL(1, capture_count);
+}
+
+void test_CallSites_EnableByFileBasename(void) {
+    TEST_ASSERT_GREATER_OR_EQUAL(3,
+        log_site_set("TestCallSites.c", NULL, NULL, LOG_SITE_ON));
+
+    quiet_path();
+    TEST_ASSERT_EQUAL(1, capture_count);
+}
+
+void test_CallSites_DisableByFormat(void) {
+    TEST_ASSERT_EQUAL(1, log_site_set(NULL, NULL, "retry*%u", LOG_SITE_OFF));
+
+    noisy_info();
+    TEST_ASSERT_EQUAL(0, capture_count);
+
+    log_site_set(NULL, NULL, "retry*", LOG_SITE_DEFAULT);
+    noisy_info();
+    TEST_ASSERT_EQUAL(1, capture_count);
+}
+
+void test_CallSites_NoMatch(void) {
+    TEST_ASSERT_EQUAL(0, log_site_set("missing.c", NULL, NULL, LOG_SITE_ON));
+}
+
+void test_CallSites_RuntimeFormatHasNoFormat(void) {
+    const log_site_t* runtime_site = NULL;
+
+    runtime_format("dynamic message");
+    TEST_ASSERT_EQUAL_STRING("[info] dynamic message\n", capture_buffer);
+
+    for (size_t i = 0; i < log_site_count(); i++) {
+        const log_site_t* site = log_site_get(i);
+        if (strcmp(site->function, "runtime_format") == 0) {
+            runtime_site = site;
+        }
+    }
+    TEST_ASSERT_NOT_NULL(runtime_site);
+    TEST_ASSERT_NULL(runtime_site->format);
+
+    /* Format globs never match it; function globs still do */
+    log_site_set(NULL, NULL, "*", LOG_SITE_OFF);
+    capture_count = 0;
+    runtime_format("still logged");
+    TEST_ASSERT_EQUAL(1, capture_count);
+
+    log_site_set(NULL, "runtime_format", NULL, LOG_SITE_OFF);
+    capture_count = 0;
+    runtime_format("silenced");
+    TEST_ASSERT_EQUAL(0, capture_count);
+}
+
+void test_CallSites_FlagFollowsCallback(void) {
+    log_site_set(NULL, "verbose_path", NULL, LOG_SITE_ON);
+    log_set_output_callback(NULL);
+
+    verbose_path();
+    TEST_ASSERT_EQUAL(0, capture_count);
+
+    log_set_output_callback(mock_output_callback);
+    verbose_path();
+    TEST_ASSERT_EQUAL(1, capture_count);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_CallSites_RegistryEnumeratesSites);
+    RUN_TEST(test_CallSites_DebugSuppressedByDefault);
+    RUN_TEST(test_CallSites_EnableByFunction);
+    RUN_TEST(test_CallSites_EnableByFileBasename);
+    RUN_TEST(test_CallSites_DisableByFormat);
+    RUN_TEST(test_CallSites_NoMatch);
+    RUN_TEST(test_CallSites_RuntimeFormatHasNoFormat);
+    RUN_TEST(test_CallSites_FlagFollowsCallback);
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <string.h>
+#include <pthread.h>
+
+#include "unity.h"
+#include "log_c.h"
+
+static char capture_buffer[512];
+static size_t capture_length;
+
+static void mock_output_callback(const char* message, size_t length) {
+    if (length < sizeof(capture_buffer)) {
+        memcpy(capture_buffer, message, length);
+        capture_length = length;
+        capture_buffer[length] = '\0';
+    }
+}
+
+void setUp(void) {
+    capture_length = 0;
+    capture_buffer[0] = '\0';
+    log_context_clear();
+    log_set_output_callback(mock_output_callback);
+}
+
+void tearDown(void) {
+    log_set_output_callback(NULL);
+    log_context_clear();
+}
+
+void test_Context_EmptyByDefault(void) {
+    loginfo("plain");
+
+    TEST_ASSERT_EQUAL_STRING("[info] plain\n", capture_buffer);
+}
+
+void test_Context_ThreadId(void) {
+    log_context_set_thread_id(7);
+    loginfo("hello");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [tid=7] hello\n", capture_buffer);
+}
+
+void test_Context_AllFields(void) {
+    log_context_set_thread_id(3);
+    log_context_set_request_id(1042);
+    log_context_set_component("net");
+    logerror("code %d", -5);
+
+    TEST_ASSERT_EQUAL_STRING("[error] [tid=3 req=1042 net] code -5\n",
+                             capture_buffer);
+}
+
+void test_Context_AllFieldsAtMaximumLength(void) {
+    /* Component is cut to LOG_CONTEXT_COMPONENT_SIZE - 1 (31) characters */
+    log_context_set_thread_id(4294967295u);
+    log_context_set_request_id(4294967295u);
+    log_context_set_component("abcdefghijklmnopqrstuvwxyz0123456789");
+    loginfo("msg");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [tid=4294967295 req=4294967295 "
+                             "abcdefghijklmnopqrstuvwxyz01234] msg\n",
+                             capture_buffer);
+}
+
+void test_Context_ClearRequestId(void) {
+    log_context_set_request_id(99);
+    log_context_set_component("db");
+    log_context_clear_request_id();
+    loginfo("done");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [db] done\n", capture_buffer);
+}
+
+void test_Context_ComponentIsCopied(void) {
+    char name[8] = "parser";
+
+    log_context_set_component(name);
+    strcpy(name, "xxxxxx");
+    loginfo("ok");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [parser] ok\n", capture_buffer);
+}
+
+void test_Context_RemoveComponent(void) {
+    log_context_set_thread_id(1);
+    log_context_set_component("io");
+    log_context_set_component(NULL);
+    loginfo("ok");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [tid=1] ok\n", capture_buffer);
+}
+
+static void* other_thread(void* arg) {
+    (void)arg;
+    log_context_set_thread_id(2);
+    log_context_set_component("worker");
+    return NULL;
+}
+
+void test_Context_IsPerThread(void) {
+    pthread_t thread;
+
+    log_context_set_thread_id(1);
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, other_thread, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, NULL));
+    loginfo("main");
+
+    TEST_ASSERT_EQUAL_STRING("[info] [tid=1] main\n", capture_buffer);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_Context_EmptyByDefault);
+    RUN_TEST(test_Context_ThreadId);
+    RUN_TEST(test_Context_AllFields);
+    RUN_TEST(test_Context_AllFieldsAtMaximumLength);
+    RUN_TEST(test_Context_ClearRequestId);
+    RUN_TEST(test_Context_ComponentIsCopied);
+    RUN_TEST(test_Context_RemoveComponent);
+    RUN_TEST(test_Context_IsPerThread);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include <string.h>
+#include <stdio.h>
+
+#include "unity.h"
+#include "log_c.h"
+
+static char lines[64][512];
+static unsigned int line_count;
+
+static void mock_output_callback(const char* message, size_t length) {
+    if (line_count < 64 && length < sizeof(lines[0])) {
+        memcpy(lines[line_count], message, length);
+        lines[line_count][length] = '\0';
+        line_count++;
+    }
+}
+
+void setUp(void) {
+    line_count = 0;
+    log_set_output_callback(mock_output_callback);
+    log_set_level(LOG_LEVEL_INFO);
+}
+
+void tearDown(void) {
+    log_set_output_callback(NULL);
+}
+
+void test_HexDump_BufferSpecifier(void) {
+    const unsigned char key[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0x00, 0x7F };
+
+    loginfo("key=%*b end", (int)sizeof(key), key);
+
+    TEST_ASSERT_EQUAL_STRING("[info] key=deadbeef007f end\n", lines[0]);
+}
+
+void test_HexDump_BufferSpecifierAllBytes(void) {
+    unsigned char data[100];
+    char expected[512];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 37 + 11);
+    }
+
+    /* Lengths around the 16-byte vector width, from unaligned offsets */
+    for (int length = 0; length <= 40; length++) {
+        size_t pos = (size_t)snprintf(expected, sizeof(expected), "[info] ");
+        for (int i = 0; i < length; i++) {
+            pos += (size_t)snprintf(expected + pos, sizeof(expected) - pos,
+                                    "%02x", data[3 + i]);
+        }
+        snprintf(expected + pos, sizeof(expected) - pos, "\n");
+
+        line_count = 0;
+        loginfo("%*b", length, data + 3);
+        TEST_ASSERT_EQUAL_STRING(expected, lines[0]);
+    }
+}
+
+void test_HexDump_BufferSpecifierTruncates(void) {
+    unsigned char big[400];
+
+    memset(big, 0xAB, sizeof(big));
+    loginfo("%*b", (int)sizeof(big), big);
+
+    /* Fills the message buffer with whole bytes only */
+    size_t length = strlen(lines[0]);
+    TEST_ASSERT_LESS_THAN(256, length);
+    TEST_ASSERT_GREATER_THAN(200, length);
+    TEST_ASSERT_EQUAL(0, (length - strlen("[info] ")) % 2);
+    TEST_ASSERT_EQUAL('b', lines[0][length - 1]);
+}
+
+void test_HexDump_BufferSpecifierEmpty(void) {
+    loginfo("[%*b]", 0, "x");
+
+    TEST_ASSERT_EQUAL_STRING("[info] []\n", lines[0]);
+}
+
+void test_HexDump_SingleLine(void) {
+    unsigned char data[16] = "Hello, log-c!";
+
+    data[13] = 0x00;
+    data[14] = 0x01;
+    data[15] = 0x02;
+    log_hexdump(info, "rx", data, sizeof(data));
+
+    TEST_ASSERT_EQUAL(1, line_count);
+    TEST_ASSERT_EQUAL_STRING(
+        "[info] rx 00000000: 48656c6c 6f2c206c 6f672d63 21000102  |Hello, log-c!...|\n",
+        lines[0]);
+}
+
+void test_HexDump_SplitsIntoLines(void) {
+    unsigned char data[40];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)(0x41 + i);
+    }
+    log_hexdump(info, NULL, data, sizeof(data));
+
+    TEST_ASSERT_EQUAL(3, line_count);
+    TEST_ASSERT_EQUAL_STRING(
+        "[info] 00000010: 51525354 55565758 595a5b5c 5d5e5f60  |QRSTUVWXYZ[\\]^_`|\n",
+        lines[1]);
+    /* Partial last line keeps the ASCII column aligned */
+    TEST_ASSERT_EQUAL_STRING(
+        "[info] 00000020: 61626364 65666768                    |abcdefgh|\n",
+        lines[2]);
+}
+
+void test_HexDump_NonPrintable(void) {
+    unsigned char data[] = { 0x00, 0x1F, 0x20, 0x7E, 0x7F, 0x80, 0xFF };
+
+    log_hexdump(info, NULL, data, sizeof(data));
+
+    TEST_ASSERT_NOT_NULL(strstr(lines[0], "|.. ~...|"));
+}
+
+void test_HexDump_RespectsRuntimeLevel(void) {
+    unsigned char data[4] = { 1, 2, 3, 4 };
+
+    log_set_level(LOG_LEVEL_WARNING);
+    log_hexdump(info, NULL, data, sizeof(data));
+    loghexdump(info, NULL, data, sizeof(data));
+    TEST_ASSERT_EQUAL(0, line_count);
+
+    loghexdump(error, "err", data, sizeof(data));
+    TEST_ASSERT_EQUAL(1, line_count);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_HexDump_BufferSpecifier);
+    RUN_TEST(test_HexDump_BufferSpecifierAllBytes);
+    RUN_TEST(test_HexDump_BufferSpecifierTruncates);
+    RUN_TEST(test_HexDump_BufferSpecifierEmpty);
+    RUN_TEST(test_HexDump_SingleLine);
+    RUN_TEST(test_HexDump_SplitsIntoLines);
+    RUN_TEST(test_HexDump_NonPrintable);
+    RUN_TEST(test_HexDump_RespectsRuntimeLevel);
+    return UNITY_END();
+}
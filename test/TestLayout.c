@@ -0,0 +1,153 @@
+#include <string.h>
+
+#include "unity.h"
+#include "log_c.h"
+
+static char capture_buffer[512];
+static size_t capture_length;
+static const char* captured_text;
+static size_t captured_text_length;
+
+static void mock_output_callback(const char* message, size_t length) {
+    if (length < sizeof(capture_buffer)) {
+        memcpy(capture_buffer, message, length);
+        capture_length = length;
+        capture_buffer[length] = '\0';
+    }
+}
+
+static void mock_record_callback(const log_record_t* record) {
+    /* Points into capture_buffer, which holds the same message */
+    captured_text = capture_buffer + (record->text - record->message);
+    captured_text_length = record->text_length;
+}
+
+static size_t mock_timestamp(char* buffer, size_t size) {
+    const char* stamp = "12.345";
+    size_t len = strlen(stamp);
+    if (len > size) len = size;
+    memcpy(buffer, stamp, len);
+    return len;
+}
+
+static void log_from_function(void) {
+    logwarning("inside");
+}
+
+void setUp(void) {
+    capture_length = 0;
+    capture_buffer[0] = '\0';
+    log_set_output_callback(mock_output_callback);
+}
+
+void tearDown(void) {
+    log_set_output_callback(NULL);
+    log_set_record_callback(NULL);
+    log_set_timestamp_callback(NULL);
+    log_set_layout(NULL);
+    log_context_clear();
+}
+
+void test_Layout_DefaultUnchanged(void) {
+    loginfo("plain %d", 1);
+
+    TEST_ASSERT_EQUAL_STRING("[info] plain 1\n", capture_buffer);
+}
+
+void test_Layout_LevelAndMessage(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%L: %M\n"));
+    logerror("code %d", 5);
+
+    TEST_ASSERT_EQUAL_STRING("error: code 5\n", capture_buffer);
+}
+
+void test_Layout_FullPattern(void) {
+    log_set_timestamp_callback(mock_timestamp);
+    log_context_set_thread_id(3);
+    log_context_set_component("net");
+    TEST_ASSERT_TRUE(log_set_layout("%T %L %t [%m] %M\n"));
+    loginfo("started");
+
+    TEST_ASSERT_EQUAL_STRING("12.345 info 3 [net] started\n", capture_buffer);
+}
+
+void test_Layout_UnsetContextFields(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%t/%r/%m %M"));
+    loginfo("x");
+
+    TEST_ASSERT_EQUAL_STRING("-/-/- x", capture_buffer);
+}
+
+void test_Layout_ContextPrefix(void) {
+    log_context_set_request_id(77);
+    TEST_ASSERT_TRUE(log_set_layout("<%L> %C%M\n"));
+    loginfo("req");
+
+    TEST_ASSERT_EQUAL_STRING("<info> [req=77] req\n", capture_buffer);
+}
+
+void test_Layout_CallSiteFields(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%f %M"));
+    log_from_function();
+    TEST_ASSERT_EQUAL_STRING("log_from_function inside", capture_buffer);
+
+    TEST_ASSERT_TRUE(log_set_layout("%F:%l %f %M"));
+    log_message(info, "direct");
+    TEST_ASSERT_EQUAL_STRING("-:- - direct", capture_buffer);
+}
+
+void test_Layout_PercentAndNoTimestampCallback(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%%[%T]%M"));
+    loginfo("p");
+
+    TEST_ASSERT_EQUAL_STRING("%[]p", capture_buffer);
+}
+
+void test_Layout_RejectsInvalidPattern(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%L %M\n"));
+    TEST_ASSERT_FALSE(log_set_layout("%Q"));
+    TEST_ASSERT_FALSE(log_set_layout("%M %M"));
+    TEST_ASSERT_FALSE(log_set_layout("trailing %"));
+
+    /* Previous layout is kept */
+    loginfo("kept");
+    TEST_ASSERT_EQUAL_STRING("info kept\n", capture_buffer);
+}
+
+void test_Layout_RejectsTooManyOps(void) {
+    TEST_ASSERT_FALSE(log_set_layout(
+        "%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L%L"));
+}
+
+void test_Layout_RecordTextIsMessage(void) {
+    log_set_record_callback(mock_record_callback);
+    TEST_ASSERT_TRUE(log_set_layout("%L | %M |\n"));
+    loginfo("body %u", 9);
+
+    TEST_ASSERT_EQUAL(strlen("body 9"), captured_text_length);
+    TEST_ASSERT_EQUAL_MEMORY("body 9", captured_text, captured_text_length);
+}
+
+void test_Layout_RestoreDefault(void) {
+    TEST_ASSERT_TRUE(log_set_layout("%M"));
+    TEST_ASSERT_TRUE(log_set_layout(NULL));
+    loginfo("back");
+
+    TEST_ASSERT_EQUAL_STRING("[info] back\n", capture_buffer);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_Layout_DefaultUnchanged);
+    RUN_TEST(test_Layout_LevelAndMessage);
+    RUN_TEST(test_Layout_FullPattern);
+    RUN_TEST(test_Layout_UnsetContextFields);
+    RUN_TEST(test_Layout_ContextPrefix);
+    RUN_TEST(test_Layout_CallSiteFields);
+    RUN_TEST(test_Layout_PercentAndNoTimestampCallback);
+    RUN_TEST(test_Layout_RejectsInvalidPattern);
+    RUN_TEST(test_Layout_RejectsTooManyOps);
+    RUN_TEST(test_Layout_RecordTextIsMessage);
+    RUN_TEST(test_Layout_RestoreDefault);
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "unity.h"
+#include "log_c.h"
+#include "log_c_binary.h"
+
+#define QUERY_TOOL "../tools/logc_query"
+#define PHASE_MESSAGES 1500
+
+static const char* test_path = "TestLogcQuery.logb";
+
+static char boundary[32];
+static int warning_line;
+static int shared_line;
+
+typedef struct {
+    int status;
+    unsigned int lines;
+    char first[256];
+    char last[256];
+} query_result_t;
+
+static unsigned long long realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+static void log_phase(const char* phase) {
+    for (int i = 0; i < PHASE_MESSAGES; i++) {
+        if (i % 100 == 0) {
+            warning_line = __LINE__; logwarning("%s warning %d", phase, i);
+        } else {
+            loginfo("%s message used to fill several blocks: %d", phase, i);
+        }
+    }
+}
+
+/* Two call sites on one line; FILE:LINE cannot tell them apart */
+static void log_shared_line(void) {
+    shared_line = __LINE__; loginfo("shared a"); loginfo("shared b");
+}
+
+/* Run the tool on the test file and summarize its output */
+static query_result_t query(const char* args) {
+    query_result_t result = { 0 };
+    char command[512];
+    char line[256];
+
+    snprintf(command, sizeof(command), QUERY_TOOL " %s %s 2>&1", args, test_path);
+    FILE* pipe = popen(command, "r");
+    TEST_ASSERT_NOT_NULL(pipe);
+
+    while (fgets(line, sizeof(line), pipe) != NULL) {
+        line[strcspn(line, "\n")] = '\0';
+        if (result.lines++ == 0) {
+            strcpy(result.first, line);
+        }
+        strcpy(result.last, line);
+    }
+
+    int status = pclose(pipe);
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    result.status = WEXITSTATUS(status);
+    return result;
+}
+
+void setUp(void) {
+    struct timespec pause = { 0, 2000000 };
+
+    log_set_level(LOG_LEVEL_INFO);
+    log_set_record_callback(log_binary_sink_record);
+    TEST_ASSERT_TRUE(log_binary_sink_open(test_path));
+
+    /* Two phases with a time gap, each large enough for several blocks */
+    log_phase("early");
+    nanosleep(&pause, NULL);
+    unsigned long long split = realtime_ns();
+    snprintf(boundary, sizeof(boundary), "%llu.%09llu",
+             split / 1000000000ull, split % 1000000000ull);
+    nanosleep(&pause, NULL);
+    log_phase("late");
+    log_shared_line();
+
+    log_set_record_callback(NULL);
+    TEST_ASSERT_TRUE(log_binary_sink_close());
+}
+
+void tearDown(void) {
+    remove(test_path);
+}
+
+void test_LogcQuery_AllRecords(void) {
+    query_result_t result = query("");
+
+    TEST_ASSERT_EQUAL(0, result.status);
+    TEST_ASSERT_EQUAL(2 * PHASE_MESSAGES + 2, result.lines);
+    TEST_ASSERT_EQUAL_STRING("[warning] early warning 0", result.first);
+    TEST_ASSERT_EQUAL_STRING("[info] shared b", result.last);
+}
+
+void test_LogcQuery_LevelFilter(void) {
+    query_result_t result = query("-l warning");
+
+    TEST_ASSERT_EQUAL(0, result.status);
+    TEST_ASSERT_EQUAL(2 * PHASE_MESSAGES / 100, result.lines);
+    TEST_ASSERT_EQUAL_STRING("[warning] early warning 0", result.first);
+    TEST_ASSERT_EQUAL_STRING("[warning] late warning 1400", result.last);
+
+    TEST_ASSERT_EQUAL(0, query("-l critical").lines);
+}
+
+void test_LogcQuery_TimeWindow(void) {
+    char args[64];
+
+    snprintf(args, sizeof(args), "-e %s", boundary);
+    query_result_t early = query(args);
+    TEST_ASSERT_EQUAL(0, early.status);
+    TEST_ASSERT_EQUAL(PHASE_MESSAGES, early.lines);
+    TEST_ASSERT_EQUAL_STRING("[info] early message used to fill several blocks: 1499",
+                             early.last);
+
+    snprintf(args, sizeof(args), "-s %s -l warning", boundary);
+    query_result_t late = query(args);
+    TEST_ASSERT_EQUAL(0, late.status);
+    TEST_ASSERT_EQUAL(PHASE_MESSAGES / 100, late.lines);
+    TEST_ASSERT_EQUAL_STRING("[warning] late warning 0", late.first);
+}
+
+void test_LogcQuery_SiteFilter(void) {
+    char args[64];
+
+    snprintf(args, sizeof(args), "-c TestLogcQuery.c:%d", warning_line);
+    query_result_t result = query(args);
+
+    TEST_ASSERT_EQUAL(0, result.status);
+    TEST_ASSERT_EQUAL(2 * PHASE_MESSAGES / 100, result.lines);
+    TEST_ASSERT_EQUAL_STRING("[warning] early warning 0", result.first);
+    TEST_ASSERT_EQUAL_STRING("[warning] late warning 1400", result.last);
+}
+
+void test_LogcQuery_SiteIdFilter(void) {
+    char args[64];
+
+    snprintf(args, sizeof(args), "-c %zu", log_site_count() - 1);
+    TEST_ASSERT_EQUAL(0, query(args).status);
+
+    /* Out of range, and too large for a 32-bit id */
+    snprintf(args, sizeof(args), "-c %zu", log_site_count());
+    query_result_t result = query(args);
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_NOT_NULL(strstr(result.first, "unknown call site"));
+
+    result = query("-c 4294967296");
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_EQUAL_STRING("unknown call site: 4294967296", result.first);
+}
+
+void test_LogcQuery_AmbiguousSiteRejected(void) {
+    char args[64];
+
+    snprintf(args, sizeof(args), "-c TestLogcQuery.c:%d", shared_line);
+    query_result_t result = query(args);
+
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_NOT_NULL(strstr(result.first, "ambiguous call site"));
+}
+
+void test_LogcQuery_OverflowingTimeRejected(void) {
+    query_result_t result = query("-s 99999999999999999999");
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_EQUAL_STRING("invalid start time: 99999999999999999999", result.first);
+
+    /* Fits in 64 bits as seconds, but not once scaled to nanoseconds */
+    result = query("-s 18446744074");
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_EQUAL_STRING("invalid start time: 18446744074", result.first);
+
+    result = query("-e -1");
+    TEST_ASSERT_EQUAL(2, result.status);
+    TEST_ASSERT_EQUAL_STRING("invalid end time: -1", result.first);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_LogcQuery_AllRecords);
+    RUN_TEST(test_LogcQuery_LevelFilter);
+    RUN_TEST(test_LogcQuery_TimeWindow);
+    RUN_TEST(test_LogcQuery_SiteFilter);
+    RUN_TEST(test_LogcQuery_SiteIdFilter);
+    RUN_TEST(test_LogcQuery_AmbiguousSiteRejected);
+    RUN_TEST(test_LogcQuery_OverflowingTimeRejected);
+    return UNITY_END();
+}
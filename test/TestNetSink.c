@@ -0,0 +1,196 @@
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "unity.h"
+#include "log_c.h"
+#include "log_c_net.h"
+
+static int receiver_fd;
+static unsigned short receiver_port;
+static char datagram[2048];
+
+/* Bind a loopback UDP receiver on an ephemeral port */
+static void open_receiver(void) {
+    struct sockaddr_in addr;
+    socklen_t addr_length = sizeof(addr);
+    struct timeval timeout = { .tv_sec = 1, .tv_usec = 0 };
+
+    receiver_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    TEST_ASSERT_TRUE(receiver_fd >= 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    TEST_ASSERT_EQUAL(0, bind(receiver_fd, (struct sockaddr*)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, getsockname(receiver_fd, (struct sockaddr*)&addr, &addr_length));
+    receiver_port = ntohs(addr.sin_port);
+
+    setsockopt(receiver_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+/* Receive one datagram into `datagram` (null-terminated) */
+static ssize_t receive(void) {
+    ssize_t length = recv(receiver_fd, datagram, sizeof(datagram) - 1, 0);
+    datagram[length > 0 ? length : 0] = '\0';
+    return length;
+}
+
+static unsigned int count_lines(const char* text) {
+    unsigned int lines = 0;
+    for (; *text != '\0'; text++) {
+        lines += (*text == '\n');
+    }
+    return lines;
+}
+
+static bool open_sink(log_net_framing_e framing, size_t mtu) {
+    log_net_config_t config = {
+        .host = "127.0.0.1",
+        .port = receiver_port,
+        .framing = framing,
+        .mtu = mtu,
+        .flush_interval_ms = 10000,
+        .app_name = "test",
+        .hostname = "host"
+    };
+    return log_net_sink_open(&config);
+}
+
+void setUp(void) {
+    open_receiver();
+    log_net_sink_reset_stats();
+    log_set_level(LOG_LEVEL_INFO);
+    log_set_record_callback(log_net_sink_record);
+}
+
+void tearDown(void) {
+    log_set_record_callback(NULL);
+    log_net_sink_close();
+    close(receiver_fd);
+}
+
+void test_NetSink_CoalescesMessages(void) {
+    log_net_stats_t stats;
+
+    TEST_ASSERT_TRUE(open_sink(LOG_NET_FRAMING_NEWLINE, 0));
+    for (int i = 0; i < 10; i++) {
+        loginfo("message %d", i);
+    }
+    TEST_ASSERT_TRUE(log_net_sink_flush());
+
+    TEST_ASSERT_GREATER_THAN(0, receive());
+    TEST_ASSERT_EQUAL(10, count_lines(datagram));
+    TEST_ASSERT_EQUAL(datagram, strstr(datagram, "[info] message 0\n[info] message 1\n"));
+
+    log_net_sink_get_stats(&stats);
+    TEST_ASSERT_EQUAL(10, stats.messages);
+    TEST_ASSERT_EQUAL(1, stats.datagrams_sent);
+    TEST_ASSERT_EQUAL(0, stats.datagrams_dropped);
+}
+
+void test_NetSink_SplitsAtMtu(void) {
+    log_net_stats_t stats;
+    unsigned int lines = 0;
+    unsigned int datagrams = 0;
+
+    TEST_ASSERT_TRUE(open_sink(LOG_NET_FRAMING_NEWLINE, 100));
+    for (int i = 0; i < 20; i++) {
+        loginfo("message number %d", i);
+    }
+    TEST_ASSERT_TRUE(log_net_sink_flush());
+
+    log_net_sink_get_stats(&stats);
+    for (unsigned long i = 0; i < stats.datagrams_sent; i++) {
+        ssize_t length = receive();
+        TEST_ASSERT_GREATER_THAN(0, length);
+        TEST_ASSERT_LESS_OR_EQUAL(100, length);
+        TEST_ASSERT_EQUAL('\n', datagram[length - 1]);
+        lines += count_lines(datagram);
+        datagrams++;
+    }
+
+    TEST_ASSERT_GREATER_THAN(1, datagrams);
+    TEST_ASSERT_EQUAL(20, lines);
+}
+
+void test_NetSink_Rfc5424Framing(void) {
+    TEST_ASSERT_TRUE(open_sink(LOG_NET_FRAMING_RFC5424, 0));
+    logerror("disk %s full", "sda");
+    TEST_ASSERT_TRUE(log_net_sink_flush());
+
+    TEST_ASSERT_GREATER_THAN(0, receive());
+    /* facility user (1) * 8 + severity error (3) */
+    TEST_ASSERT_EQUAL(datagram, strstr(datagram, "<11>1 "));
+    TEST_ASSERT_NOT_NULL(strstr(datagram, "Z host test "));
+    TEST_ASSERT_NOT_NULL(strstr(datagram, " - - disk sda full\n"));
+}
+
+void test_NetSink_FlushesOnInterval(void) {
+    log_net_config_t config = {
+        .host = "127.0.0.1",
+        .port = receiver_port,
+        .flush_interval_ms = 20
+    };
+
+    TEST_ASSERT_TRUE(log_net_sink_open(&config));
+    loginfo("timed");
+
+    /* No explicit flush: the flusher thread sends it */
+    TEST_ASSERT_GREATER_THAN(0, receive());
+    TEST_ASSERT_EQUAL_STRING("[info] timed\n", datagram);
+}
+
+void test_NetSink_CountsDroppedDatagrams(void) {
+    log_net_stats_t stats;
+
+    TEST_ASSERT_TRUE(open_sink(LOG_NET_FRAMING_NEWLINE, 0));
+    close(receiver_fd);
+    receiver_fd = -1;
+
+    /* The port is now closed; the kernel reports ECONNREFUSED on the
+     * connected socket after the first unreachable datagram */
+    for (int i = 0; i < 5; i++) {
+        loginfo("lost %d", i);
+        log_net_sink_flush();
+    }
+
+    log_net_sink_get_stats(&stats);
+    TEST_ASSERT_EQUAL(5, stats.messages);
+    TEST_ASSERT_EQUAL(5, stats.datagrams_sent + stats.datagrams_dropped);
+    TEST_ASSERT_GREATER_THAN(0, stats.datagrams_dropped);
+    TEST_ASSERT_EQUAL(stats.datagrams_dropped, stats.messages_dropped);
+}
+
+void test_NetSink_ClosedSinkDropsRecords(void) {
+    log_net_stats_t stats;
+
+    loginfo("nowhere");
+
+    log_net_sink_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.messages_dropped);
+    TEST_ASSERT_FALSE(log_net_sink_flush());
+}
+
+void test_NetSink_InvalidConfig(void) {
+    log_net_config_t config = { .host = "127.0.0.1", .port = 0 };
+
+    TEST_ASSERT_FALSE(log_net_sink_open(NULL));
+    TEST_ASSERT_FALSE(log_net_sink_open(&config));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_NetSink_CoalescesMessages);
+    RUN_TEST(test_NetSink_SplitsAtMtu);
+    RUN_TEST(test_NetSink_Rfc5424Framing);
+    RUN_TEST(test_NetSink_FlushesOnInterval);
+    RUN_TEST(test_NetSink_CountsDroppedDatagrams);
+    RUN_TEST(test_NetSink_ClosedSinkDropsRecords);
+    RUN_TEST(test_NetSink_InvalidConfig);
+    return UNITY_END();
+}
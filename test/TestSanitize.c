@@ -0,0 +1,161 @@
+#include <string.h>
+#include <stdio.h>
+
+#include "unity.h"
+#include "log_c.h"
+
+static char output[1024];
+static size_t output_length;
+static char record_text[1024];
+
+static void mock_output_callback(const char* message, size_t length) {
+    if (length < sizeof(output)) {
+        memcpy(output, message, length);
+        output[length] = '\0';
+        output_length = length;
+    }
+}
+
+static void mock_record_callback(const log_record_t* record) {
+    if (record->text_length < sizeof(record_text)) {
+        memcpy(record_text, record->text, record->text_length);
+        record_text[record->text_length] = '\0';
+    }
+}
+
+void setUp(void) {
+    output[0] = '\0';
+    output_length = 0;
+    record_text[0] = '\0';
+    log_set_output_callback(mock_output_callback);
+    log_set_level(LOG_LEVEL_INFO);
+    log_set_sanitize(true);
+}
+
+void tearDown(void) {
+    log_set_sanitize(false);
+    log_set_output_callback(NULL);
+    log_set_record_callback(NULL);
+}
+
+void test_Sanitize_DisabledCopiesRaw(void) {
+    log_set_sanitize(false);
+    TEST_ASSERT_FALSE(log_get_sanitize());
+
+    loginfo("user=%s", "a\nb");
+
+    TEST_ASSERT_EQUAL_STRING("[info] user=a\nb\n", output);
+}
+
+void test_Sanitize_CleanInputUnchanged(void) {
+    TEST_ASSERT_TRUE(log_get_sanitize());
+
+    loginfo("user=%s id=%d", "alice@example.com C:\\path ~!", 7);
+
+    TEST_ASSERT_EQUAL_STRING("[info] user=alice@example.com C:\\path ~! id=7\n", output);
+}
+
+void test_Sanitize_EscapesLineBreaks(void) {
+    loginfo("user=%s", "eve\n[error] forged\r\tline");
+
+    TEST_ASSERT_EQUAL_STRING("[info] user=eve\\n[error] forged\\r\\tline\n", output);
+}
+
+void test_Sanitize_EscapesOtherControlBytes(void) {
+    loginfo("%s", "\x1b[31mred\x7f\x01");
+
+    TEST_ASSERT_EQUAL_STRING("[info] \\x1b[31mred\\x7f\\x01\n", output);
+}
+
+void test_Sanitize_KeepsWellFormedUtf8(void) {
+    /* 2-, 3- and 4-byte sequences: e-acute, euro sign, U+1F600 */
+    loginfo("%s", "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80");
+
+    TEST_ASSERT_EQUAL_STRING("[info] caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\n", output);
+}
+
+void test_Sanitize_EscapesInvalidUtf8(void) {
+    loginfo("%s", "\x80|\xc0\xaf|\xed\xa0\x80|\xf4\x90\x80\x80|\xff|\xe2\x82");
+
+    TEST_ASSERT_EQUAL_STRING("[info] \\x80|\\xc0\\xaf|\\xed\\xa0\\x80|"
+                             "\\xf4\\x90\\x80\\x80|\\xff|\\xe2\\x82\n", output);
+}
+
+void test_Sanitize_FormatStringIsTrusted(void) {
+    loginfo("a\tb %s", "c\td");
+
+    TEST_ASSERT_EQUAL_STRING("[info] a\tb c\\td\n", output);
+}
+
+void test_Sanitize_AppliesToRecordText(void) {
+    log_set_record_callback(mock_record_callback);
+
+    loginfo("%s", "x\ny");
+
+    TEST_ASSERT_EQUAL_STRING("x\\ny", record_text);
+}
+
+void test_Sanitize_SpecialByteAtEveryVectorOffset(void) {
+    char input[48];
+    char expected[64];
+
+    /* Cover vector-aligned positions, the tail and the scalar remainder */
+    for (size_t at = 0; at < sizeof(input) - 1; at++) {
+        memset(input, 'a', sizeof(input) - 1);
+        input[sizeof(input) - 1] = '\0';
+        input[at] = '\n';
+
+        memcpy(expected, "[info] ", 7);
+        memset(expected + 7, 'a', at);
+        memcpy(expected + 7 + at, "\\n", 2);
+        memset(expected + 9 + at, 'a', sizeof(input) - 2 - at);
+        memcpy(expected + 7 + sizeof(input), "\n", 2);
+
+        loginfo("%s", input);
+        TEST_ASSERT_EQUAL_STRING(expected, output);
+    }
+}
+
+void test_Sanitize_TruncationDoesNotSplitEscapes(void) {
+    char input[400];
+
+    memset(input, 'a', sizeof(input) - 1);
+    input[sizeof(input) - 1] = '\0';
+    input[246] = '\x01';
+
+    loginfo("%s", input);
+
+    /* "[info] " + 246 * 'a' leaves 2 bytes, too few for "\x01" */
+    TEST_ASSERT_EQUAL(7 + 246 + 1, output_length);
+    TEST_ASSERT_EQUAL_CHAR('a', output[output_length - 2]);
+    TEST_ASSERT_EQUAL_CHAR('\n', output[output_length - 1]);
+}
+
+void test_Sanitize_TruncationDoesNotSplitUtf8(void) {
+    char input[400];
+
+    memset(input, 'a', sizeof(input) - 1);
+    input[sizeof(input) - 1] = '\0';
+    memcpy(input + 246, "\xe2\x82\xac", 3);
+
+    loginfo("%s", input);
+
+    TEST_ASSERT_EQUAL(7 + 246 + 1, output_length);
+    TEST_ASSERT_EQUAL_CHAR('a', output[output_length - 2]);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_Sanitize_DisabledCopiesRaw);
+    RUN_TEST(test_Sanitize_CleanInputUnchanged);
+    RUN_TEST(test_Sanitize_EscapesLineBreaks);
+    RUN_TEST(test_Sanitize_EscapesOtherControlBytes);
+    RUN_TEST(test_Sanitize_KeepsWellFormedUtf8);
+    RUN_TEST(test_Sanitize_EscapesInvalidUtf8);
+    RUN_TEST(test_Sanitize_FormatStringIsTrusted);
+    RUN_TEST(test_Sanitize_AppliesToRecordText);
+    RUN_TEST(test_Sanitize_SpecialByteAtEveryVectorOffset);
+    RUN_TEST(test_Sanitize_TruncationDoesNotSplitEscapes);
+    RUN_TEST(test_Sanitize_TruncationDoesNotSplitUtf8);
+    return UNITY_END();
+}
@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "unity.h"
+#include "log_c.h"
+#include "log_c_shm.h"
+#include "log_c_binary.h"
+
+#define MAX_COLLECTED 4096
+#define COLLECTOR_TOOL "../tools/logc_collector"
+
+static const char* binary_path = "TestShmRing.logb";
+
+typedef struct {
+    char text[64];
+    int pid;
+    unsigned long long timestamp;
+    log_level_e level;
+} collected_t;
+
+static char segment_name[64];
+static collected_t collected[MAX_COLLECTED];
+static size_t collected_count;
+
+static void collect_handler(const log_shm_message_t* message) {
+    if (collected_count < MAX_COLLECTED) {
+        collected_t* entry = &collected[collected_count++];
+        size_t length = message->text_length;
+
+        if (length >= sizeof(entry->text)) {
+            length = sizeof(entry->text) - 1;
+        }
+        memcpy(entry->text, message->text, length);
+        entry->text[length] = '\0';
+        entry->pid = message->pid;
+        entry->timestamp = message->timestamp;
+        entry->level = message->level;
+    }
+}
+
+static size_t collect(void) {
+    return log_shm_collect(collect_handler);
+}
+
+static size_t attached_producers(void) {
+    size_t attached = 0;
+
+    for (size_t i = 0; i < log_shm_max_producers(); i++) {
+        log_shm_producer_stats_t stats;
+        if (log_shm_get_producer_stats(i, &stats) && stats.pid != 0) {
+            attached++;
+        }
+    }
+    return attached;
+}
+
+/* Fork a producer that logs count messages and exits, detaching or not */
+static pid_t spawn_producer(const char* tag, int count, bool detach) {
+    pid_t pid = fork();
+
+    if (pid == 0) {
+        if (!log_shm_attach(segment_name)) {
+            _exit(1);
+        }
+        log_set_record_callback(log_shm_record);
+        for (int i = 0; i < count; i++) {
+            loginfo("%s %d", tag, i);
+        }
+        if (detach) {
+            log_set_record_callback(NULL);
+            log_shm_detach();
+        }
+        /* Without detach this looks like a crash to the collector */
+        _exit(0);
+    }
+    return pid;
+}
+
+static void wait_for(pid_t pid) {
+    int status = 0;
+
+    TEST_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+}
+
+void setUp(void) {
+    snprintf(segment_name, sizeof(segment_name), "/logc_test_%d", (int)getpid());
+    collected_count = 0;
+    log_set_output_callback(NULL);
+    log_set_record_callback(NULL);
+    log_set_level(LOG_LEVEL_DEBUG);
+    TEST_ASSERT_TRUE(log_shm_create(segment_name));
+}
+
+void tearDown(void) {
+    log_set_record_callback(NULL);
+    log_shm_detach();
+    log_shm_destroy(segment_name);
+    remove(binary_path);
+}
+
+void test_ShmRing_AttachFailsWithoutSegment(void) {
+    log_shm_destroy(segment_name);
+    TEST_ASSERT_FALSE(log_shm_attach(segment_name));
+    TEST_ASSERT_TRUE(log_shm_create(segment_name));
+}
+
+void test_ShmRing_CollectsOwnMessages(void) {
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    TEST_ASSERT_FALSE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+
+    logerror("first %d", 1);
+    logwarning("second");
+
+    TEST_ASSERT_EQUAL(2, collect());
+    TEST_ASSERT_EQUAL_STRING("first 1", collected[0].text);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_ERROR, collected[0].level);
+    TEST_ASSERT_EQUAL_STRING("second", collected[1].text);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARNING, collected[1].level);
+    TEST_ASSERT_EQUAL((int)getpid(), collected[0].pid);
+    TEST_ASSERT_TRUE(collected[0].timestamp <= collected[1].timestamp);
+
+    /* Nothing new */
+    TEST_ASSERT_EQUAL(0, collect());
+}
+
+void test_ShmRing_DetachFreesRing(void) {
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+    loginfo("before detach");
+    log_set_record_callback(NULL);
+    log_shm_detach();
+
+    TEST_ASSERT_EQUAL(1, attached_producers());
+    TEST_ASSERT_EQUAL(1, collect());
+    TEST_ASSERT_EQUAL_STRING("before detach", collected[0].text);
+    TEST_ASSERT_EQUAL(0, attached_producers());
+
+    /* The ring can be claimed again */
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+}
+
+void test_ShmRing_FullRingDropsInsteadOfBlocking(void) {
+    log_shm_producer_stats_t stats;
+    int logged = 0;
+
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+
+    for (; logged < 10000; logged++) {
+        loginfo("fill %d", logged);
+    }
+
+    size_t count = collect();
+    TEST_ASSERT_TRUE(count > 0 && count < (size_t)logged);
+
+    bool found = false;
+    for (size_t i = 0; i < log_shm_max_producers(); i++) {
+        if (log_shm_get_producer_stats(i, &stats) && stats.pid == (int)getpid()) {
+            found = true;
+            break;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_TRUE(stats.active);
+    TEST_ASSERT_EQUAL((unsigned long long)logged - count, stats.dropped);
+
+    /* Oldest messages were kept, in order */
+    TEST_ASSERT_EQUAL_STRING("fill 0", collected[0].text);
+    TEST_ASSERT_EQUAL_STRING("fill 1", collected[1].text);
+
+    /* Space is available again after collecting */
+    loginfo("after drain");
+    TEST_ASSERT_EQUAL(1, collect());
+}
+
+void test_ShmRing_MergesProducerProcesses(void) {
+    pid_t a = spawn_producer("a", 50, true);
+    pid_t b = spawn_producer("b", 50, true);
+    wait_for(a);
+    wait_for(b);
+
+    TEST_ASSERT_EQUAL(100, collect());
+    TEST_ASSERT_EQUAL(0, attached_producers());
+
+    int next_a = 0;
+    int next_b = 0;
+    for (size_t i = 0; i < collected_count; i++) {
+        char expected[16];
+
+        if (i > 0) {
+            TEST_ASSERT_TRUE(collected[i - 1].timestamp <= collected[i].timestamp);
+        }
+        if (collected[i].pid == a) {
+            snprintf(expected, sizeof(expected), "a %d", next_a++);
+        } else {
+            TEST_ASSERT_EQUAL(b, collected[i].pid);
+            snprintf(expected, sizeof(expected), "b %d", next_b++);
+        }
+        TEST_ASSERT_EQUAL_STRING(expected, collected[i].text);
+    }
+    TEST_ASSERT_EQUAL(50, next_a);
+    TEST_ASSERT_EQUAL(50, next_b);
+}
+
+void test_ShmRing_DeadProducerIsDrainedAndReclaimed(void) {
+    pid_t pid = spawn_producer("crash", 3, false);
+    wait_for(pid);
+
+    /* The ring is still claimed by the exited process until collected */
+    TEST_ASSERT_EQUAL(1, attached_producers());
+
+    TEST_ASSERT_EQUAL(3, collect());
+    TEST_ASSERT_EQUAL_STRING("crash 0", collected[0].text);
+    TEST_ASSERT_EQUAL_STRING("crash 2", collected[2].text);
+    TEST_ASSERT_EQUAL(pid, collected[2].pid);
+    TEST_ASSERT_EQUAL(0, attached_producers());
+}
+
+void test_ShmRing_RestartedCollectorAdoptsSegment(void) {
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+    loginfo("queued");
+
+    /* Unmap without removing, then create again as a new collector would */
+    log_shm_destroy(NULL);
+    TEST_ASSERT_TRUE(log_shm_create(segment_name));
+
+    TEST_ASSERT_EQUAL(1, collect());
+    TEST_ASSERT_EQUAL_STRING("queued", collected[0].text);
+    TEST_ASSERT_EQUAL(1, attached_producers());
+}
+
+void test_ShmRing_CollectorKeepsProducerTimestamp(void) {
+    struct timespec pause = { 0, 1000000 };
+    struct timespec delay = { 0, 50000000 };
+    struct timespec ts;
+    log_binary_file_header_t header;
+    log_binary_block_header_t block;
+    log_binary_record_header_t record;
+    unsigned long long logged_at;
+    int status = 0;
+
+    /* Log and detach before any collector runs */
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+    loginfo("delayed");
+    log_set_record_callback(NULL);
+    log_shm_detach();
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    logged_at = (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+    nanosleep(&delay, NULL);
+
+    pid_t collector = fork();
+    if (collector == 0) {
+        execl(COLLECTOR_TOOL, COLLECTOR_TOOL, "-n", segment_name, "-b", binary_path,
+              "-i", "1", (char*)NULL);
+        _exit(127);
+    }
+    TEST_ASSERT_TRUE(collector > 0);
+
+    /* The detached ring is returned to the pool once it has been drained */
+    for (int i = 0; i < 5000 && attached_producers() != 0; i++) {
+        nanosleep(&pause, NULL);
+    }
+    TEST_ASSERT_EQUAL(0, attached_producers());
+    kill(collector, SIGTERM);
+    TEST_ASSERT_EQUAL(collector, waitpid(collector, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+
+    /* Without -x the segment outlives the collector */
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_shm_detach();
+
+    FILE* file = fopen(binary_path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL(1, fread(&header, sizeof(header), 1, file));
+    fseek(file, (long)header.site_table_size, SEEK_CUR);
+    TEST_ASSERT_EQUAL(1, fread(&block, sizeof(block), 1, file));
+    TEST_ASSERT_EQUAL(1, fread(&record, sizeof(record), 1, file));
+    fclose(file);
+
+    /* Stamped when logged, not 50 ms later when the collector started */
+    TEST_ASSERT_EQUAL(1, block.record_count);
+    TEST_ASSERT_EQUAL(7, record.length);
+    TEST_ASSERT_TRUE(record.timestamp != 0 && record.timestamp <= logged_at);
+    TEST_ASSERT_EQUAL(record.timestamp, block.first_timestamp);
+}
+
+#define THREADS 4
+#define THREAD_MESSAGES 50
+
+static void* thread_producer(void* arg) {
+    int id = (int)(size_t)arg;
+
+    for (int i = 0; i < THREAD_MESSAGES; i++) {
+        loginfo("t%d %d", id, i);
+    }
+    return NULL;
+}
+
+void test_ShmRing_ThreadsShareRing(void) {
+    pthread_t threads[THREADS];
+    int next[THREADS] = { 0 };
+
+    TEST_ASSERT_TRUE(log_shm_attach(segment_name));
+    log_set_record_callback(log_shm_record);
+
+    for (size_t i = 0; i < THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, thread_producer, (void*)i));
+    }
+    for (size_t i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    TEST_ASSERT_EQUAL(THREADS * THREAD_MESSAGES, collect());
+
+    /* Each thread's messages arrive complete and in order */
+    for (size_t i = 0; i < collected_count; i++) {
+        int id;
+        int sequence;
+        TEST_ASSERT_EQUAL(2, sscanf(collected[i].text, "t%d %d", &id, &sequence));
+        TEST_ASSERT_TRUE(id >= 0 && id < THREADS);
+        TEST_ASSERT_EQUAL(next[id]++, sequence);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ShmRing_AttachFailsWithoutSegment);
+    RUN_TEST(test_ShmRing_CollectsOwnMessages);
+    RUN_TEST(test_ShmRing_DetachFreesRing);
+    RUN_TEST(test_ShmRing_FullRingDropsInsteadOfBlocking);
+    RUN_TEST(test_ShmRing_MergesProducerProcesses);
+    RUN_TEST(test_ShmRing_DeadProducerIsDrainedAndReclaimed);
+    RUN_TEST(test_ShmRing_RestartedCollectorAdoptsSegment);
+    RUN_TEST(test_ShmRing_CollectorKeepsProducerTimestamp);
+    RUN_TEST(test_ShmRing_ThreadsShareRing);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+
+#include "unity.h"
+#include "log_c.h"
+#include "log_c_trace.h"
+
+static char json[8192];
+static size_t json_length;
+
+static void json_writer(const char* chunk, size_t length) {
+    if (json_length + length < sizeof(json)) {
+        memcpy(json + json_length, chunk, length);
+        json_length += length;
+        json[json_length] = '\0';
+    }
+}
+
+static void export_trace(void) {
+    json_length = 0;
+    json[0] = '\0';
+    log_trace_export(json_writer);
+}
+
+static unsigned int count_events(void) {
+    unsigned int events = 0;
+    for (const char* p = json; (p = strstr(p, "\"ph\":\"X\"")) != NULL; p++) {
+        events++;
+    }
+    return events;
+}
+
+static void inner(void) {
+    logspan("inner");
+}
+
+static void outer(void) {
+    logspan("outer");
+    inner();
+    inner();
+}
+
+void setUp(void) {
+    log_trace_reset();
+    log_trace_set_enabled(true);
+    log_context_clear();
+}
+
+void tearDown(void) {
+    log_trace_set_enabled(false);
+    log_context_clear();
+}
+
+void test_Trace_DisabledRecordsNothing(void) {
+    log_trace_set_enabled(false);
+    outer();
+    export_trace();
+
+    TEST_ASSERT_EQUAL(0, count_events());
+    TEST_ASSERT_EQUAL_STRING("{\"traceEvents\":[\n],\"displayTimeUnit\":\"ns\"}\n", json);
+}
+
+void test_Trace_ScopedSpans(void) {
+    outer();
+    export_trace();
+
+    TEST_ASSERT_EQUAL(3, count_events());
+    TEST_ASSERT_NOT_NULL(strstr(json, "{\"name\":\"inner\",\"ph\":\"X\",\"ts\":"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "{\"name\":\"outer\",\"ph\":\"X\",\"ts\":"));
+
+    /* Inner spans complete first */
+    TEST_ASSERT_TRUE(strstr(json, "\"inner\"") < strstr(json, "\"outer\""));
+}
+
+void test_Trace_UsesContextThreadId(void) {
+    log_context_set_thread_id(42);
+    inner();
+    export_trace();
+
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"tid\":42}"));
+}
+
+void test_Trace_ExplicitBeginEnd(void) {
+    log_span_t span = log_span_begin("manual");
+    TEST_ASSERT_NOT_EQUAL(0, span);
+    log_span_end(span);
+    export_trace();
+
+    TEST_ASSERT_EQUAL(1, count_events());
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"manual\""));
+}
+
+void test_Trace_EscapesNames(void) {
+    log_span_end(log_span_begin("say \"hi\"\\"));
+    export_trace();
+
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"name\":\"say \\\"hi\\\"\\\\\""));
+}
+
+void test_Trace_DurationIsNonNegative(void) {
+    log_span_t span = log_span_begin("timed");
+    for (volatile int i = 0; i < 100000; i++) {
+    }
+    log_span_end(span);
+    export_trace();
+
+    const char* dur = strstr(json, "\"dur\":");
+    TEST_ASSERT_NOT_NULL(dur);
+    TEST_ASSERT_TRUE(strtod(dur + 6, NULL) > 0.0);
+}
+
+static void* worker(void* arg) {
+    (void)arg;
+    log_context_set_thread_id(7);
+    outer();
+    return NULL;
+}
+
+void test_Trace_CollectsOtherThreads(void) {
+    pthread_t thread;
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&thread, NULL, worker, NULL));
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, NULL));
+    export_trace();
+
+    /* Buffers outlive their threads */
+    TEST_ASSERT_EQUAL(3, count_events());
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"tid\":7}"));
+}
+
+void test_Trace_ResetClears(void) {
+    outer();
+    log_trace_reset();
+    export_trace();
+
+    TEST_ASSERT_EQUAL(0, count_events());
+    TEST_ASSERT_EQUAL(0, log_trace_dropped());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_Trace_DisabledRecordsNothing);
+    RUN_TEST(test_Trace_ScopedSpans);
+    RUN_TEST(test_Trace_UsesContextThreadId);
+    RUN_TEST(test_Trace_ExplicitBeginEnd);
+    RUN_TEST(test_Trace_EscapesNames);
+    RUN_TEST(test_Trace_DurationIsNonNegative);
+    RUN_TEST(test_Trace_CollectsOtherThreads);
+    RUN_TEST(test_Trace_ResetClears);
+    return UNITY_END();
+}
@@ -0,0 +1,265 @@
+/* logc_collector - merge shared-memory log rings into real sinks
+ *
+ * Creates (or adopts) the shared-memory segment of src/log_c_shm.c and
+ * polls it, writing the messages of all attached producer processes in
+ * timestamp order to a text file, a binary log file and/or a UDP
+ * collector. Rings of producers that detached or died are drained and
+ * reclaimed. On SIGINT or SIGTERM the rings are drained one last time and
+ * the segment is unmapped but left in place, so running producers keep
+ * logging into it and a restarted collector picks up where this one
+ * stopped. Use -x to remove it instead.
+ *
+ * Usage: logc_collector [options]
+ *   -n NAME        Segment name (default "/logc")
+ *   -o FILE        Append text lines to FILE ("-" for stdout, the default
+ *                  when neither -b nor -u is given)
+ *   -b FILE        Write an indexed binary log (see logc_query)
+ *   -u HOST:PORT   Forward to a UDP collector, one message per line
+ *   -i MS          Poll interval in milliseconds (default 10)
+ *   -p             Prefix text lines with the producer pid
+ *   -x             Remove the segment on exit (producers must re-attach
+ *                  to a new collector)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log_c_binary.h"
+#include "log_c_net.h"
+#include "log_c_shm.h"
+
+/** @brief Collector options and sinks */
+typedef struct {
+    FILE* text;                 /**< Text output, NULL if disabled */
+    bool binary;                /**< Binary sink is open */
+    bool net;                   /**< Network sink is open */
+    bool show_pid;              /**< Prefix text lines with the pid */
+} collector_t;
+
+static collector_t g_collector;
+static volatile sig_atomic_t g_stop;
+
+static void on_signal(int signal_number) {
+    (void)signal_number;
+    g_stop = 1;
+}
+
+static void forward_message(const log_shm_message_t* message) {
+    log_record_t record = {
+        .level = message->level,
+        .site = NULL,           /* Sites of other processes are not known here */
+        .message = message->message,
+        .length = message->length,
+        .text = message->text,
+        .text_length = message->text_length,
+        .timestamp = message->timestamp     /* Time logged, not time collected */
+    };
+
+    if (g_collector.text != NULL) {
+        if (g_collector.show_pid) {
+            fprintf(g_collector.text, "%d: ", message->pid);
+        }
+        fwrite(message->message, 1, message->length, g_collector.text);
+        /* Messages truncated by the producer have no newline */
+        if (message->length == 0 || message->message[message->length - 1] != '\n') {
+            fputc('\n', g_collector.text);
+        }
+    }
+    if (g_collector.binary) {
+        log_binary_sink_record(&record);
+    }
+    if (g_collector.net) {
+        log_net_sink_record(&record);
+    }
+}
+
+/**
+ * @brief Report messages dropped by producers since the last pass
+ */
+static void report_drops(int* last_pid, unsigned long long* last_dropped) {
+    size_t count = log_shm_max_producers();
+
+    for (size_t i = 0; i < count; i++) {
+        log_shm_producer_stats_t stats;
+
+        if (!log_shm_get_producer_stats(i, &stats)) {
+            continue;
+        }
+        if (stats.pid != last_pid[i]) {
+            last_pid[i] = stats.pid;
+            last_dropped[i] = 0;
+        }
+        if (stats.dropped > last_dropped[i]) {
+            fprintf(stderr, "logc_collector: pid %d dropped %llu messages\n",
+                    stats.pid, stats.dropped - last_dropped[i]);
+            last_dropped[i] = stats.dropped;
+        }
+    }
+}
+
+static bool parse_host_port(char* arg, log_net_config_t* config) {
+    char* colon = strrchr(arg, ':');
+    char* end;
+
+    if (colon == NULL || colon == arg) {
+        return false;
+    }
+
+    unsigned long port = strtoul(colon + 1, &end, 10);
+    if (*end != '\0' || port == 0 || port > 65535) {
+        return false;
+    }
+
+    *colon = '\0';
+    config->host = arg;
+    config->port = (unsigned short)port;
+    return true;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [-n NAME] [-o FILE] [-b FILE] [-u HOST:PORT] [-i MS] [-p] [-x]\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    const char* name = "/logc";
+    const char* text_path = NULL;
+    const char* binary_path = NULL;
+    log_net_config_t net_config = { .framing = LOG_NET_FRAMING_NEWLINE };
+    bool has_net = false;
+    bool remove_segment = false;
+    unsigned long interval_ms = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:o:b:u:i:px")) != -1) {
+        char* end;
+
+        switch (opt) {
+            case 'n':
+                name = optarg;
+                break;
+            case 'o':
+                text_path = optarg;
+                break;
+            case 'b':
+                binary_path = optarg;
+                break;
+            case 'u':
+                if (!parse_host_port(optarg, &net_config)) {
+                    fprintf(stderr, "invalid address: %s\n", optarg);
+                    return 2;
+                }
+                has_net = true;
+                break;
+            case 'i':
+                interval_ms = strtoul(optarg, &end, 10);
+                if (*end != '\0' || interval_ms == 0) {
+                    fprintf(stderr, "invalid interval: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'p':
+                g_collector.show_pid = true;
+                break;
+            case 'x':
+                remove_segment = true;
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind != argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (text_path == NULL && binary_path == NULL && !has_net) {
+        text_path = "-";
+    }
+    if (text_path != NULL) {
+        g_collector.text = (strcmp(text_path, "-") == 0) ? stdout : fopen(text_path, "a");
+        if (g_collector.text == NULL) {
+            perror(text_path);
+            return 1;
+        }
+    }
+    if (binary_path != NULL) {
+        if (!log_binary_sink_open(binary_path)) {
+            perror(binary_path);
+            return 1;
+        }
+        g_collector.binary = true;
+    }
+    if (has_net) {
+        if (!log_net_sink_open(&net_config)) {
+            fprintf(stderr, "cannot open UDP sink to %s:%u\n", net_config.host,
+                    (unsigned int)net_config.port);
+            return 1;
+        }
+        g_collector.net = true;
+    }
+
+    if (!log_shm_create(name)) {
+        perror(name);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    size_t producers = log_shm_max_producers();
+    int* last_pid = calloc(producers, sizeof(*last_pid));
+    unsigned long long* last_dropped = calloc(producers, sizeof(*last_dropped));
+    if (last_pid == NULL || last_dropped == NULL) {
+        perror("calloc");
+        return 1;
+    }
+
+    struct timespec interval = {
+        .tv_sec = (time_t)(interval_ms / 1000u),
+        .tv_nsec = (long)(interval_ms % 1000u) * 1000000L
+    };
+
+    while (!g_stop) {
+        if (log_shm_collect(forward_message) > 0 && g_collector.text != NULL) {
+            fflush(g_collector.text);
+        }
+        report_drops(last_pid, last_dropped);
+        nanosleep(&interval, NULL);
+    }
+
+    log_shm_collect(forward_message);
+    report_drops(last_pid, last_dropped);
+    /* Unlinking would leave attached producers writing to an orphaned
+       mapping that no later collector can see */
+    log_shm_destroy(remove_segment ? name : NULL);
+
+    if (g_collector.text != NULL) {
+        fflush(g_collector.text);
+        if (g_collector.text != stdout) {
+            fclose(g_collector.text);
+        }
+    }
+    if (g_collector.binary) {
+        log_binary_sink_close();
+    }
+    if (g_collector.net) {
+        log_net_sink_close();
+    }
+
+    free(last_pid);
+    free(last_dropped);
+    return 0;
+}
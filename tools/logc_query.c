@@ -0,0 +1,422 @@
+/* logc_query - filter and render binary log files
+ *
+ * Maps a file written by the binary sink (src/log_c_binary.c) and prints
+ * the matching records as "[level] message" lines. Blocks whose index
+ * header cannot match the query (time range, level mask, site mask) are
+ * skipped without touching their records.
+ *
+ * Usage: logc_query [options] FILE
+ *   -s START   Only records at or after START (seconds since epoch, may
+ *              have a fraction, e.g. 1700000000.25)
+ *   -e END     Only records at or before END (same format)
+ *   -l LEVEL   Only records at or below LEVEL (name or number)
+ *   -c SITE    Only records from SITE (site id or FILE:LINE)
+ *   -t         Prefix each line with its timestamp
+ *   -S         List the call-site table and exit
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "log_c_binary.h"
+
+/** @brief Decoded site table entry (strings point into the mapping) */
+typedef struct {
+    log_binary_site_entry_t entry;
+    const char* file;
+    const char* function;
+    const char* format;
+} query_site_t;
+
+/** @brief Query parameters */
+typedef struct {
+    uint64_t start;             /**< Earliest timestamp (ns) */
+    uint64_t end;               /**< Latest timestamp (ns) */
+    uint32_t level_mask;        /**< Accepted levels */
+    uint32_t site_id;           /**< Accepted site, or LOG_SITE_ID_NONE for any */
+    bool has_site;              /**< site_id filter is active */
+    bool show_timestamp;        /**< Print timestamps */
+} query_t;
+
+static const char* level_name(unsigned int level) {
+    static const char* const names[] = {
+        "off", "critical", "error", "warning", "info", "debug"
+    };
+    return (level <= LOG_LEVEL_MAX) ? names[level] : "unknown";
+}
+
+static bool parse_level(const char* str, unsigned int* level) {
+    for (unsigned int l = LOG_LEVEL_CRITICAL; l <= LOG_LEVEL_MAX; l++) {
+        if (strcmp(str, level_name(l)) == 0) {
+            *level = l;
+            return true;
+        }
+    }
+
+    char* end;
+    unsigned long value = strtoul(str, &end, 10);
+    if (*str == '\0' || *end != '\0' || value > LOG_LEVEL_MAX) {
+        return false;
+    }
+    *level = (unsigned int)value;
+    return true;
+}
+
+/**
+ * @brief Parse "SECONDS[.FRACTION]" into nanoseconds without going through
+ *        double, which cannot hold nanosecond epoch times exactly
+ */
+static bool parse_time(const char* str, uint64_t* ns) {
+    char* end;
+    uint64_t fraction = 0;
+    uint64_t scale = 100000000u;
+
+    /* strtoull() would accept a sign and wrap negative values */
+    if (*str < '0' || *str > '9') {
+        return false;
+    }
+
+    errno = 0;
+    unsigned long long seconds = strtoull(str, &end, 10);
+    if (errno == ERANGE || seconds > (UINT64_MAX - 999999999u) / 1000000000u) {
+        return false;
+    }
+
+    if (*end == '.') {
+        for (end++; *end >= '0' && *end <= '9'; end++) {
+            fraction += (uint64_t)(*end - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    if (*end != '\0') {
+        return false;
+    }
+
+    *ns = (uint64_t)seconds * 1000000000u + fraction;
+    return true;
+}
+
+/**
+ * @brief Resolve "ID" or "FILE:LINE" (FILE matched by basename too)
+ * @param ambiguous Set if FILE:LINE names more than one site
+ * @return true if exactly one site matches
+ */
+static bool parse_site(const char* str, const query_site_t* sites,
+                       uint32_t count, uint32_t* site_id, bool* ambiguous) {
+    const char* colon = strrchr(str, ':');
+    bool found = false;
+    char* end;
+
+    *ambiguous = false;
+
+    if (colon == NULL) {
+        if (*str < '0' || *str > '9') {
+            return false;
+        }
+        errno = 0;
+        unsigned long value = strtoul(str, &end, 10);
+        /* count fits in uint32_t, so this also rejects truncated values */
+        if (*end != '\0' || errno == ERANGE || value >= count) {
+            return false;
+        }
+        *site_id = (uint32_t)value;
+        return true;
+    }
+
+    unsigned long line = strtoul(colon + 1, &end, 10);
+    size_t name_length = (size_t)(colon - str);
+    if (*end != '\0') {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const query_site_t* site = &sites[i];
+        size_t file_length = site->entry.file_length;
+        const char* base = site->file;
+
+        for (size_t j = 0; j < file_length; j++) {
+            if (site->file[j] == '/') {
+                base = site->file + j + 1;
+            }
+        }
+        size_t base_length = file_length - (size_t)(base - site->file);
+
+        if (site->entry.line != line) {
+            continue;
+        }
+        if ((file_length == name_length && memcmp(site->file, str, name_length) == 0) ||
+            (base_length == name_length && memcmp(base, str, name_length) == 0)) {
+            if (found) {
+                *ambiguous = true;
+                return false;
+            }
+            *site_id = i;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Decode the site table that follows the file header
+ * @return Array of count sites (caller frees), or NULL on malformed input
+ */
+static query_site_t* load_sites(const unsigned char* data, size_t size,
+                                const log_binary_file_header_t* header) {
+    query_site_t* sites = calloc(header->site_count ? header->site_count : 1,
+                                 sizeof(*sites));
+    size_t pos = sizeof(*header);
+    size_t table_end = pos + header->site_table_size;
+
+    if (sites == NULL || table_end > size) {
+        free(sites);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < header->site_count; i++) {
+        query_site_t* site = &sites[i];
+
+        if (pos + sizeof(site->entry) > table_end) {
+            free(sites);
+            return NULL;
+        }
+        memcpy(&site->entry, data + pos, sizeof(site->entry));
+        pos += sizeof(site->entry);
+
+        size_t strings = (size_t)site->entry.file_length +
+                         site->entry.function_length + site->entry.format_length;
+        if (pos + strings > table_end) {
+            free(sites);
+            return NULL;
+        }
+        site->file = (const char*)data + pos;
+        site->function = site->file + site->entry.file_length;
+        site->format = site->function + site->entry.function_length;
+        pos += strings;
+    }
+
+    return sites;
+}
+
+static void list_sites(const query_site_t* sites, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        const query_site_t* site = &sites[i];
+        printf("%u\t%.*s:%u\t%.*s\t[%s] %.*s\n", i,
+               (int)site->entry.file_length, site->file, site->entry.line,
+               (int)site->entry.function_length, site->function,
+               level_name(site->entry.level),
+               (int)site->entry.format_length, site->format);
+    }
+}
+
+/**
+ * @brief Check whether a block's index header can contain matching records
+ */
+static bool block_may_match(const log_binary_block_header_t* block,
+                            const query_t* query) {
+    if (block->last_timestamp < query->start ||
+        block->first_timestamp > query->end) {
+        return false;
+    }
+    if ((block->level_mask & query->level_mask) == 0) {
+        return false;
+    }
+    if (query->has_site &&
+        (block->site_mask & ((uint64_t)1 << (query->site_id & 63u))) == 0) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Print the matching records of one block
+ */
+static void print_block(const unsigned char* payload,
+                        const log_binary_block_header_t* block,
+                        const query_t* query) {
+    size_t pos = 0;
+
+    for (uint32_t i = 0; i < block->record_count; i++) {
+        log_binary_record_header_t record;
+
+        if (pos + sizeof(record) > block->payload_size) {
+            return;
+        }
+        memcpy(&record, payload + pos, sizeof(record));
+        pos += sizeof(record);
+
+        if (pos + record.length > block->payload_size) {
+            return;
+        }
+        const char* text = (const char*)payload + pos;
+        pos += record.length;
+
+        if (record.timestamp < query->start || record.timestamp > query->end ||
+            (query->level_mask & (1u << (record.level & 31u))) == 0 ||
+            (query->has_site && record.site_id != query->site_id)) {
+            continue;
+        }
+
+        if (query->show_timestamp) {
+            printf("%llu.%09llu ",
+                   (unsigned long long)(record.timestamp / 1000000000u),
+                   (unsigned long long)(record.timestamp % 1000000000u));
+        }
+        printf("[%s] %.*s\n", level_name(record.level), (int)record.length, text);
+    }
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [-s START] [-e END] [-l LEVEL] [-c SITE] [-t] [-S] FILE\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    query_t query = {
+        .start = 0,
+        .end = UINT64_MAX,
+        .level_mask = 0xFFFFFFFFu,
+        .site_id = LOG_SITE_ID_NONE,
+        .has_site = false,
+        .show_timestamp = false
+    };
+    const char* site_arg = NULL;
+    bool list = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:e:l:c:tS")) != -1) {
+        unsigned int level;
+
+        switch (opt) {
+            case 's':
+                if (!parse_time(optarg, &query.start)) {
+                    fprintf(stderr, "invalid start time: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'e':
+                if (!parse_time(optarg, &query.end)) {
+                    fprintf(stderr, "invalid end time: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'l':
+                if (!parse_level(optarg, &level)) {
+                    fprintf(stderr, "invalid level: %s\n", optarg);
+                    return 2;
+                }
+                /* Levels 1..level; bit 0 (off) is never written */
+                query.level_mask = ((1u << (level + 1)) - 1u) & ~1u;
+                break;
+            case 'c':
+                site_arg = optarg;
+                break;
+            case 't':
+                query.show_timestamp = true;
+                break;
+            case 'S':
+                list = true;
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char* path = argv[optind];
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(log_binary_file_header_t)) {
+        fprintf(stderr, "%s: not a binary log file\n", path);
+        close(fd);
+        return 1;
+    }
+
+    const unsigned char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    log_binary_file_header_t header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC)) != 0 ||
+        header.byte_order != LOG_BINARY_BYTE_ORDER ||
+        header.version != LOG_BINARY_VERSION) {
+        fprintf(stderr, "%s: not a binary log file (or foreign byte order)\n", path);
+        munmap((void*)data, size);
+        return 1;
+    }
+
+    query_site_t* sites = load_sites(data, size, &header);
+    if (sites == NULL) {
+        fprintf(stderr, "%s: corrupt site table\n", path);
+        munmap((void*)data, size);
+        return 1;
+    }
+
+    int status = 0;
+    bool ambiguous = false;
+
+    if (list) {
+        list_sites(sites, header.site_count);
+    } else if (site_arg != NULL &&
+               !parse_site(site_arg, sites, header.site_count, &query.site_id,
+                           &ambiguous)) {
+        if (ambiguous) {
+            fprintf(stderr, "ambiguous call site: %s (use an id from -S)\n", site_arg);
+        } else {
+            fprintf(stderr, "unknown call site: %s\n", site_arg);
+        }
+        status = 2;
+    } else {
+        query.has_site = (site_arg != NULL);
+        posix_madvise((void*)data, size, POSIX_MADV_RANDOM);
+
+        size_t pos = sizeof(header) + header.site_table_size;
+        while (pos + sizeof(log_binary_block_header_t) <= size) {
+            log_binary_block_header_t block;
+            memcpy(&block, data + pos, sizeof(block));
+            pos += sizeof(block);
+
+            if (block.magic != LOG_BINARY_BLOCK_MAGIC ||
+                pos + block.payload_size > size) {
+                fprintf(stderr, "%s: truncated or corrupt block\n", path);
+                status = 1;
+                break;
+            }
+
+            if (block_may_match(&block, &query)) {
+                print_block(data + pos, &block, &query);
+            }
+            pos += block.payload_size;
+        }
+    }
+
+    free(sites);
+    munmap((void*)data, size);
+    return status;
+}